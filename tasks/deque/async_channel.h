@@ -0,0 +1,293 @@
+#pragma once
+#include <coroutine>
+#include <optional>
+#include <stdexcept>
+#include <unordered_set>
+#include <vector>
+
+#include "deque.h"
+
+class AsyncTask {
+ public:
+  struct promise_type {
+    AsyncTask get_return_object() {
+      return AsyncTask(
+          std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+    std::suspend_always initial_suspend() noexcept {
+      return {};
+    }
+    std::suspend_always final_suspend() noexcept {
+      return {};
+    }
+    void return_void() {
+    }
+    void unhandled_exception() {
+      throw;
+    }
+  };
+
+ private:
+  std::coroutine_handle<promise_type> handle_;
+
+ public:
+  AsyncTask(std::coroutine_handle<promise_type> handle)
+      : handle_(handle) {
+  }
+  AsyncTask(const AsyncTask&) = delete;
+  AsyncTask(AsyncTask&& other)
+      : handle_(other.handle_) {
+    other.handle_ = nullptr;
+  }
+  AsyncTask& operator=(const AsyncTask&) = delete;
+  ~AsyncTask() {
+    if (handle_ != nullptr) {
+      handle_.destroy();
+    }
+  }
+
+  std::coroutine_handle<> release() {
+    std::coroutine_handle<> handle = handle_;
+    handle_ = nullptr;
+    return handle;
+  }
+};
+
+class EventLoop {
+ private:
+  Deque<std::coroutine_handle<>> ready_;
+  // frames of spawned tasks that have not finished yet, by address
+  std::unordered_set<void*> tasks_;
+
+ public:
+  EventLoop() = default;
+  EventLoop(const EventLoop&) = delete;
+  EventLoop& operator=(const EventLoop&) = delete;
+  ~EventLoop() {
+    for (void* frame : tasks_) {
+      std::coroutine_handle<>::from_address(frame).destroy();
+    }
+  }
+
+  void spawn(AsyncTask task) {
+    std::coroutine_handle<> handle = task.release();
+    tasks_.insert(handle.address());
+    schedule(handle);
+  }
+
+  size_t pending() const {
+    return tasks_.size();
+  }
+
+  void schedule(std::coroutine_handle<> handle) {
+    ready_.push_back(handle);
+  }
+
+  void run();
+};
+
+inline void EventLoop::run() {
+  while (ready_.size() > 0) {
+    std::coroutine_handle<> handle = ready_[0];
+    ready_.pop_front();
+    handle.resume();
+    // the loop owns the frames of spawned tasks: free them once they finish
+    if (handle.done() && tasks_.erase(handle.address()) > 0) {
+      handle.destroy();
+    }
+  }
+}
+
+template <typename T>
+class AsyncChannel {
+ private:
+  struct Waiter {
+    std::optional<T> value;
+    std::coroutine_handle<> handle;
+  };
+
+  EventLoop& loop_;
+  size_t capacity_;
+  bool closed_ = false;
+  Deque<T> buffer_;
+  Deque<Waiter*> senders_;
+  Deque<Waiter*> receivers_;
+
+  bool try_send(const T& value);
+  std::optional<T> try_recv();
+
+  class SendAwaiter : public Waiter {
+   private:
+    AsyncChannel& channel_;
+
+   public:
+    SendAwaiter(AsyncChannel& channel, const T& value)
+        : channel_(channel) {
+      this->value.emplace(value);
+    }
+    bool await_ready() {
+      if (channel_.try_send(*this->value)) {
+        this->value.reset();
+        return true;
+      }
+      return false;
+    }
+    void await_suspend(std::coroutine_handle<> handle) {
+      this->handle = handle;
+      channel_.senders_.push_back(this);
+    }
+    // false when the channel was closed before the value was taken
+    bool await_resume() {
+      return !this->value.has_value();
+    }
+  };
+
+  class RecvAwaiter : public Waiter {
+   private:
+    AsyncChannel& channel_;
+
+   public:
+    RecvAwaiter(AsyncChannel& channel)
+        : channel_(channel) {
+    }
+    bool await_ready() {
+      this->value = channel_.try_recv();
+      return this->value.has_value() || channel_.closed_;
+    }
+    void await_suspend(std::coroutine_handle<> handle) {
+      this->handle = handle;
+      channel_.receivers_.push_back(this);
+    }
+    std::optional<T> await_resume() {
+      return std::move(this->value);
+    }
+  };
+
+  class BatchRecvAwaiter : public Waiter {
+   private:
+    AsyncChannel& channel_;
+    size_t max_count_;
+    std::vector<T> result_;
+
+    void drain() {
+      while (result_.size() < max_count_) {
+        std::optional<T> value = channel_.try_recv();
+        if (!value.has_value()) {
+          break;
+        }
+        result_.push_back(std::move(*value));
+      }
+    }
+
+   public:
+    BatchRecvAwaiter(AsyncChannel& channel, size_t max_count)
+        : channel_(channel),
+          max_count_(max_count) {
+    }
+    bool await_ready() {
+      drain();
+      return !result_.empty() || channel_.closed_;
+    }
+    void await_suspend(std::coroutine_handle<> handle) {
+      this->handle = handle;
+      channel_.receivers_.push_back(this);
+    }
+    std::vector<T> await_resume() {
+      if (this->value.has_value()) {
+        result_.push_back(std::move(*this->value));
+        drain();
+      }
+      return std::move(result_);
+    }
+  };
+
+ public:
+  AsyncChannel(EventLoop& loop, size_t capacity)
+      : loop_(loop),
+        capacity_(capacity) {
+  }
+  AsyncChannel(const AsyncChannel&) = delete;
+  AsyncChannel& operator=(const AsyncChannel&) = delete;
+
+  SendAwaiter send(const T& value) {
+    if (closed_) {
+      throw std::logic_error("send to a closed channel");
+    }
+    return SendAwaiter(*this, value);
+  }
+
+  RecvAwaiter recv() {
+    return RecvAwaiter(*this);
+  }
+
+  BatchRecvAwaiter recv_batch(size_t max_count) {
+    return BatchRecvAwaiter(*this, max_count);
+  }
+
+  void close();
+
+  bool closed() const {
+    return closed_;
+  }
+
+  size_t size() const {
+    return buffer_.size();
+  }
+
+  size_t capacity() const {
+    return capacity_;
+  }
+};
+
+template <typename T>
+bool AsyncChannel<T>::try_send(const T& value) {
+  if (receivers_.size() > 0) {
+    Waiter* receiver = receivers_[0];
+    receivers_.pop_front();
+    receiver->value.emplace(value);
+    loop_.schedule(receiver->handle);
+    return true;
+  }
+  if (buffer_.size() < capacity_) {
+    buffer_.push_back(value);
+    return true;
+  }
+  return false;
+}
+
+template <typename T>
+std::optional<T> AsyncChannel<T>::try_recv() {
+  std::optional<T> result;
+  if (buffer_.size() > 0) {
+    result.emplace(std::move(buffer_[0]));
+    buffer_.pop_front();
+    if (senders_.size() > 0) {
+      Waiter* sender = senders_[0];
+      senders_.pop_front();
+      buffer_.push_back(std::move(*sender->value));
+      sender->value.reset();
+      loop_.schedule(sender->handle);
+    }
+  } else if (senders_.size() > 0) {
+    Waiter* sender = senders_[0];
+    senders_.pop_front();
+    result.emplace(std::move(*sender->value));
+    sender->value.reset();
+    loop_.schedule(sender->handle);
+  }
+  return result;
+}
+
+template <typename T>
+void AsyncChannel<T>::close() {
+  closed_ = true;
+  while (receivers_.size() > 0) {
+    loop_.schedule(receivers_[0]->handle);
+    receivers_.pop_front();
+  }
+  // values of parked senders are dropped; their send resumes with false
+  while (senders_.size() > 0) {
+    loop_.schedule(senders_[0]->handle);
+    senders_.pop_front();
+  }
+}
@@ -0,0 +1,292 @@
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "async_channel.h"
+
+#ifndef NO_TEST
+
+// NOLINTBEGIN
+
+AsyncTask Producer(AsyncChannel<int>& channel, int from, int to, std::vector<int>& log) {
+    for (int i = from; i < to; ++i) {
+        co_await channel.send(i);
+        log.push_back(i);
+    }
+}
+
+AsyncTask Consumer(AsyncChannel<int>& channel, std::vector<int>& received) {
+    while (true) {
+        std::optional<int> value = co_await channel.recv();
+        if (!value.has_value()) {
+            break;
+        }
+        received.push_back(*value);
+    }
+}
+
+AsyncTask BatchConsumer(AsyncChannel<int>& channel, size_t max_count,
+                        std::vector<std::vector<int>>& batches) {
+    while (true) {
+        std::vector<int> batch = co_await channel.recv_batch(max_count);
+        if (batch.empty()) {
+            break;
+        }
+        batches.push_back(std::move(batch));
+    }
+}
+
+AsyncTask Closer(AsyncChannel<int>& channel) {
+    channel.close();
+    co_return;
+}
+
+void TestOrderAndBackpressure() {
+    EventLoop loop;
+    AsyncChannel<int> channel(loop, 4);
+    std::vector<int> sent;
+    std::vector<int> received;
+
+    loop.spawn(Producer(channel, 0, 100, sent));
+    loop.run();
+
+    // nobody receives, so the producer must be parked on the fifth send
+    assert(sent.size() == 4);
+    assert(channel.size() == 4);
+
+    loop.spawn(Consumer(channel, received));
+    loop.run();
+    assert(sent.size() == 100);
+    assert(received.size() == 100);
+    for (int i = 0; i < 100; ++i) {
+        assert(received[i] == i);
+    }
+
+    loop.spawn(Closer(channel));
+    loop.run();
+}
+
+void TestRendezvous() {
+    EventLoop loop;
+    AsyncChannel<int> channel(loop, 0);
+    std::vector<int> sent;
+    std::vector<int> received;
+
+    loop.spawn(Consumer(channel, received));
+    loop.spawn(Producer(channel, 0, 10, sent));
+    loop.spawn(Producer(channel, 10, 20, sent));
+    loop.run();
+
+    assert(channel.size() == 0);
+    assert(received.size() == 20);
+    std::vector<int> sorted = received;
+    std::sort(sorted.begin(), sorted.end());
+    for (int i = 0; i < 20; ++i) {
+        assert(sorted[i] == i);
+    }
+}
+
+void TestBatchAndClose() {
+    EventLoop loop;
+    AsyncChannel<int> channel(loop, 16);
+    std::vector<int> sent;
+    std::vector<std::vector<int>> batches;
+
+    loop.spawn(Producer(channel, 0, 10, sent));
+    loop.run();
+    loop.spawn(BatchConsumer(channel, 4, batches));
+    loop.run();
+
+    assert(batches.size() == 3);
+    assert(batches[0].size() == 4);
+    assert(batches[2].size() == 2);
+    assert(batches[2][1] == 9);
+
+    loop.spawn(Closer(channel));
+    loop.run();
+    assert(batches.size() == 3);
+
+    try {
+        channel.send(1);
+        assert(false);
+    } catch (std::logic_error&) {}
+}
+
+AsyncTask StoppingProducer(AsyncChannel<int>& channel, int count, std::vector<int>& log,
+                           bool& closed) {
+    for (int i = 0; i < count; ++i) {
+        if (!co_await channel.send(i)) {
+            closed = true;
+            co_return;
+        }
+        log.push_back(i);
+    }
+}
+
+void TestCloseWithBlockedSender() {
+    EventLoop loop;
+    AsyncChannel<int> channel(loop, 2);
+    std::vector<int> sent;
+    std::vector<int> received;
+    bool closed = false;
+
+    loop.spawn(StoppingProducer(channel, 10, sent, closed));
+    loop.run();
+    assert(sent.size() == 2 && !closed);
+
+    loop.spawn(Closer(channel));
+    loop.run();
+    // the parked send finishes, reporting that its value was not delivered
+    assert(closed);
+    assert(sent.size() == 2);
+
+    // what was buffered before the close can still be received
+    loop.spawn(Consumer(channel, received));
+    loop.run();
+    assert((received == std::vector<int>{0, 1}));
+}
+
+void TestFinishedTasksAreFreed() {
+    EventLoop loop;
+    AsyncChannel<int> channel(loop, 1);
+    std::vector<int> sent;
+    std::vector<int> received;
+
+    loop.spawn(Consumer(channel, received));
+    for (int round = 0; round < 1'000; ++round) {
+        loop.spawn(Producer(channel, round, round + 1, sent));
+        loop.run();
+        // the producer is gone, only the consumer waits for more
+        assert(loop.pending() == 1);
+    }
+    assert(received.size() == 1'000 && received.back() == 999);
+
+    loop.spawn(Closer(channel));
+    loop.run();
+    assert(loop.pending() == 0);
+}
+
+template <typename T>
+class BlockingQueue {
+    std::mutex mutex_;
+    std::condition_variable not_full_;
+    std::condition_variable not_empty_;
+    std::queue<T> queue_;
+    size_t capacity_;
+
+public:
+    BlockingQueue(size_t capacity): capacity_(capacity) {}
+
+    void push(const T& value) {
+        std::unique_lock lock(mutex_);
+        not_full_.wait(lock, [&] { return queue_.size() < capacity_; });
+        queue_.push(value);
+        not_empty_.notify_one();
+    }
+
+    T pop() {
+        std::unique_lock lock(mutex_);
+        not_empty_.wait(lock, [&] { return !queue_.empty(); });
+        T value = queue_.front();
+        queue_.pop();
+        not_full_.notify_one();
+        return value;
+    }
+};
+
+AsyncTask SumConsumer(AsyncChannel<int>& channel, long long& sum) {
+    while (true) {
+        std::vector<int> batch = co_await channel.recv_batch(64);
+        if (batch.empty()) {
+            break;
+        }
+        for (int x : batch) {
+            sum += x;
+        }
+    }
+}
+
+AsyncTask CountingProducer(AsyncChannel<int>& channel, int count) {
+    for (int i = 0; i < count; ++i) {
+        co_await channel.send(i);
+    }
+    channel.close();
+}
+
+void TestPerformance() {
+    using namespace std::chrono;
+    const int count = 2'000'000;
+    const long long expected = (long long)count * (count - 1) / 2;
+
+    auto start = high_resolution_clock::now();
+    long long channel_sum = 0;
+    {
+        EventLoop loop;
+        AsyncChannel<int> channel(loop, 256);
+        loop.spawn(SumConsumer(channel, channel_sum));
+        loop.spawn(CountingProducer(channel, count));
+        loop.run();
+    }
+    auto channel_time = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+    assert(channel_sum == expected);
+
+    start = high_resolution_clock::now();
+    long long queue_sum = 0;
+    {
+        BlockingQueue<int> queue(256);
+        std::thread producer([&] {
+            for (int i = 0; i < count; ++i) {
+                queue.push(i);
+            }
+            queue.push(-1);
+        });
+        for (int x = queue.pop(); x != -1; x = queue.pop()) {
+            queue_sum += x;
+        }
+        producer.join();
+    }
+    auto queue_time = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+    assert(queue_sum == expected);
+
+    std::cerr << " AsyncChannel: " << channel_time << " ms, condition_variable queue: "
+              << queue_time << " ms" << std::endl;
+}
+
+int main() {
+    TestOrderAndBackpressure();
+    std::cerr << "Test 1 (order and backpressure) passed." << std::endl;
+
+    TestRendezvous();
+    std::cerr << "Test 2 (rendezvous) passed." << std::endl;
+
+    TestBatchAndClose();
+    std::cerr << "Test 3 (batch and close) passed." << std::endl;
+
+    TestCloseWithBlockedSender();
+    std::cerr << "Test 4 (close with a blocked sender) passed." << std::endl;
+
+    TestFinishedTasksAreFreed();
+    std::cerr << "Test 5 (finished tasks are freed) passed." << std::endl;
+
+    TestPerformance();
+    std::cerr << "Test 6 (performance) passed." << std::endl;
+
+    std::cout << 0;
+}
+
+// NOLINTEND
+
+#else
+
+int main() {
+    std::cerr << "Tests are turned off!\n";
+}
+
+#endif
@@ -1,9 +1,54 @@
 #pragma once
+#include <algorithm>
 #include <iterator>
+#include <memory>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
-template <typename T>
+struct DequeNoHooks {
+  void on_map_allocation(size_t) {
+  }
+  void on_map_deallocation(size_t) {
+  }
+  void on_map_growth(size_t, size_t) {
+  }
+  void on_chunk_allocation(size_t) {
+  }
+  void on_chunk_deallocation(size_t) {
+  }
+};
+
+struct DequeAllocationStats {
+  size_t map_growths = 0;
+  size_t chunk_allocations = 0;
+  size_t chunk_deallocations = 0;
+  size_t bytes_held = 0;
+  size_t peak_bytes = 0;
+
+  void on_map_allocation(size_t bytes) {
+    bytes_held += bytes;
+    peak_bytes = std::max(peak_bytes, bytes_held);
+  }
+  void on_map_deallocation(size_t bytes) {
+    bytes_held -= bytes;
+  }
+  void on_map_growth(size_t, size_t) {
+    ++map_growths;
+  }
+  void on_chunk_allocation(size_t bytes) {
+    ++chunk_allocations;
+    bytes_held += bytes;
+    peak_bytes = std::max(peak_bytes, bytes_held);
+  }
+  void on_chunk_deallocation(size_t bytes) {
+    ++chunk_deallocations;
+    bytes_held -= bytes;
+  }
+};
+
+template <typename T, typename Hooks = DequeNoHooks,
+          typename Allocator = std::allocator<T>>
 class Deque {
  private:
   struct Bucket {
@@ -12,12 +57,6 @@ class Deque {
     Bucket()
         : elements_(nullptr) {
     }
-    void make_bucket() {
-      elements_ = reinterpret_cast<T*>(new char[size * sizeof(T)]);
-    }
-    ~Bucket() {
-      delete[] reinterpret_cast<char*>(elements_);
-    }
     Bucket& operator=(const Bucket& other) {
       elements_ = other.elements_;
       return *this;
@@ -30,8 +69,19 @@ class Deque {
   size_t bucket_index(size_t position) const;
   size_t in_bucket_index(size_t position) const;
 
+  using ElementAllocator =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+  using element_allocator_traits = std::allocator_traits<ElementAllocator>;
+  using BucketAllocator =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<Bucket>;
+  using bucket_allocator_traits = std::allocator_traits<BucketAllocator>;
+
   size_t size_, begin_bucket_, begin_index_, bucket_quantity_;
   Bucket* buckets_;
+  [[no_unique_address]] Hooks hooks_;
+  [[no_unique_address]] ElementAllocator allocator_;
+
+  static const size_t chunk_bytes = Bucket::size * sizeof(T);
 
   template <typename... Args>
   void make_deque(size_t sz, const Args&... value);
@@ -72,7 +122,9 @@ class Deque {
     bool operator<=(const base_iterator&) const;
     bool operator>=(const base_iterator&) const;
 
-    operator base_iterator<true>() const;
+    operator base_iterator<true>() const {
+      return base_iterator<true>(bucket_, position_);
+    }
 
     base_iterator& operator+=(int);
     base_iterator& operator-=(int);
@@ -90,7 +142,7 @@ class Deque {
       return *pointer_;
     }
 
-    friend class Deque<T>;
+    friend class Deque<T, Hooks, Allocator>;
   };
   void delete_all(size_t last);
   std::pair<size_t, size_t> get_rbegin() const;
@@ -100,6 +152,11 @@ class Deque {
       const base_iterator<is_constant>&) const;
   Bucket* get_new_buckets(size_t index_to);
   void make_buckets();
+  Bucket* allocate_map(size_t count);
+  void make_chunk(Bucket& bucket);
+  void free_buckets(Bucket* buckets, size_t count);
+  template <typename Value>
+  void append(Value&& value);
 
  public:
   using iterator = base_iterator<false>;
@@ -109,20 +166,28 @@ class Deque {
   using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
   Deque()
+      : Deque(Allocator()) {
+  }
+  Deque(const Allocator& alloc)
       : size_(0),
         begin_bucket_(1),
         begin_index_(0),
-        bucket_quantity_(2) {
+        bucket_quantity_(2),
+        allocator_(alloc) {
     make_buckets();
   }
   Deque(size_t);
+  Deque(size_t, const Allocator&);
   Deque(size_t, const T&);
+  Deque(size_t, const T&, const Allocator&);
   Deque(const Deque&);
+  Deque(const Deque&, const Allocator&);
   ~Deque();
 
   Deque& operator=(const Deque&);
 
   void push_back(const T&);
+  void push_back(T&&);
   void push_front(const T&);
   void pop_back();
   void pop_front();
@@ -153,62 +218,109 @@ class Deque {
   size_t size() const {
     return size_;
   }
+
+  size_t memory_usage() const {
+    return bucket_quantity_ * (sizeof(Bucket) + chunk_bytes);
+  }
+
+  const Hooks& hooks() const {
+    return hooks_;
+  }
+
+  Allocator get_allocator() const {
+    return Allocator(allocator_);
+  }
 };
 
-template <typename T>
-typename Deque<T>::Bucket* Deque<T>::get_new_buckets(size_t index_to) {
-  Bucket* new_buckets = new Bucket[bucket_quantity_ << 1];
+template <typename T, typename Hooks, typename Allocator>
+typename Deque<T, Hooks, Allocator>::Bucket*
+Deque<T, Hooks, Allocator>::allocate_map(size_t count) {
+  BucketAllocator bucket_allocator(allocator_);
+  Bucket* buckets = bucket_allocator_traits::allocate(bucket_allocator, count);
+  for (size_t i = 0; i < count; ++i) {
+    new (buckets + i) Bucket();
+  }
+  hooks_.on_map_allocation(count * sizeof(Bucket));
+  return buckets;
+}
+
+template <typename T, typename Hooks, typename Allocator>
+void Deque<T, Hooks, Allocator>::make_chunk(Bucket& bucket) {
+  bucket.elements_ =
+      element_allocator_traits::allocate(allocator_, Bucket::size);
+  hooks_.on_chunk_allocation(chunk_bytes);
+}
+
+template <typename T, typename Hooks, typename Allocator>
+void Deque<T, Hooks, Allocator>::free_buckets(Bucket* buckets, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    if (buckets[i].elements_ != nullptr) {
+      element_allocator_traits::deallocate(allocator_, buckets[i].elements_,
+                                           Bucket::size);
+      hooks_.on_chunk_deallocation(chunk_bytes);
+    }
+  }
+  BucketAllocator bucket_allocator(allocator_);
+  bucket_allocator_traits::deallocate(bucket_allocator, buckets, count);
+  hooks_.on_map_deallocation(count * sizeof(Bucket));
+}
+
+template <typename T, typename Hooks, typename Allocator>
+typename Deque<T, Hooks, Allocator>::Bucket*
+Deque<T, Hooks, Allocator>::get_new_buckets(size_t index_to) {
+  hooks_.on_map_growth(bucket_quantity_, bucket_quantity_ << 1);
+  Bucket* new_buckets = allocate_map(bucket_quantity_ << 1);
   size_t last_bucket = get_rbegin().first;
   for (size_t i = begin_bucket_; i <= last_bucket; ++i) {
     new_buckets[index_to + i] = buckets_[i];
     buckets_[i].elements_ = nullptr;
   }
   for (size_t i = 0; i < begin_bucket_ + index_to; ++i) {
-    new_buckets[i].make_bucket();
+    make_chunk(new_buckets[i]);
   }
   for (size_t i = last_bucket + index_to + 1; i < bucket_quantity_ << 1; ++i) {
-    new_buckets[i].make_bucket();
+    make_chunk(new_buckets[i]);
   }
   return new_buckets;
 }
 
-template <typename T>
-void Deque<T>::make_buckets() {
-  buckets_ = new Bucket[bucket_quantity_];
+template <typename T, typename Hooks, typename Allocator>
+void Deque<T, Hooks, Allocator>::make_buckets() {
+  buckets_ = allocate_map(bucket_quantity_);
   for (size_t i = 0; i < bucket_quantity_; ++i) {
-    buckets_[i].make_bucket();
+    make_chunk(buckets_[i]);
   }
 }
 
-template <typename T>
-size_t Deque<T>::bucket_index(size_t position) const {
+template <typename T, typename Hooks, typename Allocator>
+size_t Deque<T, Hooks, Allocator>::bucket_index(size_t position) const {
   return position / Bucket::size;
 }
 
-template <typename T>
-size_t Deque<T>::in_bucket_index(size_t position) const {
+template <typename T, typename Hooks, typename Allocator>
+size_t Deque<T, Hooks, Allocator>::in_bucket_index(size_t position) const {
   return position % Bucket::size;
 }
 
-template <typename T>
-void Deque<T>::delete_all(size_t last) {
+template <typename T, typename Hooks, typename Allocator>
+void Deque<T, Hooks, Allocator>::delete_all(size_t last) {
   size_t i = begin_bucket_, j = begin_index_;
   for (size_t current = 0; current < last; ++current) {
-    (buckets_[i].elements_ + j)->~T();
+    element_allocator_traits::destroy(allocator_, buckets_[i].elements_ + j);
     ++j;
     if (j == Bucket::size) {
       j = 0, ++i;
     }
   }
-  delete[] buckets_;
+  free_buckets(buckets_, bucket_quantity_);
   size_ = 0;
   bucket_quantity_ = 2;
   begin_index_ = 0;
   begin_bucket_ = 1;
 }
 
-template <typename T>
-std::pair<size_t, size_t> Deque<T>::get_rbegin() const {
+template <typename T, typename Hooks, typename Allocator>
+std::pair<size_t, size_t> Deque<T, Hooks, Allocator>::get_rbegin() const {
   if (size_ == 0) {
     return {begin_bucket_ - 1, Bucket::size - 1};
   }
@@ -218,29 +330,30 @@ std::pair<size_t, size_t> Deque<T>::get_rbegin() const {
   return {index2, index1};
 }
 
-template <typename T>
-std::pair<size_t, size_t> Deque<T>::get_end() const {
+template <typename T, typename Hooks, typename Allocator>
+std::pair<size_t, size_t> Deque<T, Hooks, Allocator>::get_end() const {
   size_t index1 = begin_index_ + size_;
   size_t index2 = begin_bucket_ + index1 / Bucket::size;
   index1 %= Bucket::size;
   return {index2, index1};
 }
 
-template <typename T>
+template <typename T, typename Hooks, typename Allocator>
 template <bool is_constant>
-std::pair<size_t, size_t> Deque<T>::get_position(
+std::pair<size_t, size_t> Deque<T, Hooks, Allocator>::get_position(
     const base_iterator<is_constant>& it) const {
   return {it.bucket_ - buckets_, it.position_};
 }
 
-template <typename T>
+template <typename T, typename Hooks, typename Allocator>
 template <typename... Args>
-void Deque<T>::make_deque(size_t sz, const Args&... value) {
+void Deque<T, Hooks, Allocator>::make_deque(size_t sz, const Args&... value) {
   make_buckets();
   size_t i = begin_bucket_, j = begin_index_, current = 0;
   try {
     for (; current < sz; ++current) {
-      new (buckets_[i].elements_ + j) T(value...);
+      element_allocator_traits::construct(allocator_, buckets_[i].elements_ + j,
+                                          value...);
       ++j;
       if (j == Bucket::size) {
         j = 0, ++i;
@@ -252,35 +365,57 @@ void Deque<T>::make_deque(size_t sz, const Args&... value) {
   }
 }
 
-template <typename T>
-Deque<T>::Deque(size_t sz)
+template <typename T, typename Hooks, typename Allocator>
+Deque<T, Hooks, Allocator>::Deque(size_t sz)
+    : Deque(sz, Allocator()) {
+}
+
+template <typename T, typename Hooks, typename Allocator>
+Deque<T, Hooks, Allocator>::Deque(size_t sz, const Allocator& alloc)
     : size_(sz),
       begin_bucket_(1),
       begin_index_(0),
-      bucket_quantity_((sz + Bucket::size - 1) / Bucket::size + 2) {
+      bucket_quantity_((sz + Bucket::size - 1) / Bucket::size + 2),
+      allocator_(alloc) {
   make_deque(sz);
 }
 
-template <typename T>
-Deque<T>::Deque(size_t sz, const T& value)
+template <typename T, typename Hooks, typename Allocator>
+Deque<T, Hooks, Allocator>::Deque(size_t sz, const T& value)
+    : Deque(sz, value, Allocator()) {
+}
+
+template <typename T, typename Hooks, typename Allocator>
+Deque<T, Hooks, Allocator>::Deque(size_t sz, const T& value,
+                                  const Allocator& alloc)
     : size_(sz),
       begin_bucket_(1),
       begin_index_(0),
-      bucket_quantity_((sz + Bucket::size - 1) / Bucket::size + 2) {
+      bucket_quantity_((sz + Bucket::size - 1) / Bucket::size + 2),
+      allocator_(alloc) {
   make_deque(sz, value);
 }
 
-template <typename T>
-Deque<T>::Deque(const Deque& other)
+template <typename T, typename Hooks, typename Allocator>
+Deque<T, Hooks, Allocator>::Deque(const Deque& other)
+    : Deque(other,
+            element_allocator_traits::select_on_container_copy_construction(
+                other.allocator_)) {
+}
+
+template <typename T, typename Hooks, typename Allocator>
+Deque<T, Hooks, Allocator>::Deque(const Deque& other, const Allocator& alloc)
     : size_(other.size_),
       begin_bucket_(other.begin_bucket_),
       begin_index_(other.begin_index_),
-      bucket_quantity_(other.bucket_quantity_) {
+      bucket_quantity_(other.bucket_quantity_),
+      allocator_(alloc) {
   make_buckets();
   size_t i = begin_bucket_, j = begin_index_, current = 0;
   try {
     for (; current < size_; ++current) {
-      buckets_[i][j] = other.buckets_[i][j];
+      element_allocator_traits::construct(allocator_, buckets_[i].elements_ + j,
+                                          other.buckets_[i][j]);
       ++j;
       if (j == Bucket::size) {
         j = 0, ++i;
@@ -292,26 +427,33 @@ Deque<T>::Deque(const Deque& other)
   }
 }
 
-template <typename T>
-Deque<T>::~Deque() {
+template <typename T, typename Hooks, typename Allocator>
+Deque<T, Hooks, Allocator>::~Deque() {
   delete_all(size_);
 }
 
-template <typename T>
-Deque<T>& Deque<T>::operator=(const Deque& other) {
-  Deque new_deque(other);
+template <typename T, typename Hooks, typename Allocator>
+Deque<T, Hooks, Allocator>& Deque<T, Hooks, Allocator>::operator=(
+    const Deque& other) {
+  constexpr bool propagate = element_allocator_traits::
+      propagate_on_container_copy_assignment::value;
+  Deque new_deque(other, propagate ? other.allocator_ : allocator_);
+  if constexpr (propagate) {
+    std::swap(allocator_, new_deque.allocator_);
+  }
   std::swap(size_, new_deque.size_);
   std::swap(begin_bucket_, new_deque.begin_bucket_);
   std::swap(begin_index_, new_deque.begin_index_);
   std::swap(bucket_quantity_, new_deque.bucket_quantity_);
   std::swap(buckets_, new_deque.buckets_);
+  std::swap(hooks_, new_deque.hooks_);
   return *this;
 }
 
-template <typename T>
+template <typename T, typename Hooks, typename Allocator>
 template <bool is_constant>
-typename Deque<T>::template base_iterator<is_constant>&
-Deque<T>::base_iterator<is_constant>::operator++() {
+typename Deque<T, Hooks, Allocator>::template base_iterator<is_constant>&
+Deque<T, Hooks, Allocator>::base_iterator<is_constant>::operator++() {
   ++position_;
   if (position_ == Bucket::size) {
     ++bucket_;
@@ -323,19 +465,19 @@ Deque<T>::base_iterator<is_constant>::operator++() {
   return *this;
 }
 
-template <typename T>
+template <typename T, typename Hooks, typename Allocator>
 template <bool is_constant>
-typename Deque<T>::template base_iterator<is_constant>
-Deque<T>::base_iterator<is_constant>::operator++(int) {
+typename Deque<T, Hooks, Allocator>::template base_iterator<is_constant>
+Deque<T, Hooks, Allocator>::base_iterator<is_constant>::operator++(int) {
   base_iterator<is_constant> answer(*this);
   ++(*this);
   return answer;
 }
 
-template <typename T>
+template <typename T, typename Hooks, typename Allocator>
 template <bool is_constant>
-typename Deque<T>::template base_iterator<is_constant>&
-Deque<T>::base_iterator<is_constant>::operator--() {
+typename Deque<T, Hooks, Allocator>::template base_iterator<is_constant>&
+Deque<T, Hooks, Allocator>::base_iterator<is_constant>::operator--() {
   if (position_ == 0) {
     --bucket_;
     position_ = Bucket::size - 1;
@@ -347,62 +489,62 @@ Deque<T>::base_iterator<is_constant>::operator--() {
   return *this;
 }
 
-template <typename T>
+template <typename T, typename Hooks, typename Allocator>
 template <bool is_constant>
-typename Deque<T>::template base_iterator<is_constant>
-Deque<T>::base_iterator<is_constant>::operator--(int) {
+typename Deque<T, Hooks, Allocator>::template base_iterator<is_constant>
+Deque<T, Hooks, Allocator>::base_iterator<is_constant>::operator--(int) {
   base_iterator<is_constant> answer(*this);
   --(*this);
   return answer;
 }
 
-template <typename T>
+template <typename T, typename Hooks, typename Allocator>
 template <bool is_constant>
-bool Deque<T>::base_iterator<is_constant>::operator==(
+bool Deque<T, Hooks, Allocator>::base_iterator<is_constant>::operator==(
     const base_iterator& other) const {
   return bucket_ == other.bucket_ && position_ == other.position_;
 }
 
-template <typename T>
+template <typename T, typename Hooks, typename Allocator>
 template <bool is_constant>
-bool Deque<T>::base_iterator<is_constant>::operator!=(
+bool Deque<T, Hooks, Allocator>::base_iterator<is_constant>::operator!=(
     const base_iterator& other) const {
   return pointer_ != other.pointer_;
 }
 
-template <typename T>
+template <typename T, typename Hooks, typename Allocator>
 template <bool is_constant>
-bool Deque<T>::base_iterator<is_constant>::operator<(
+bool Deque<T, Hooks, Allocator>::base_iterator<is_constant>::operator<(
     const base_iterator& other) const {
   return (bucket_ == other.bucket_ && position_ < other.position_) ||
          (bucket_ < other.bucket_);
 }
 
-template <typename T>
+template <typename T, typename Hooks, typename Allocator>
 template <bool is_constant>
-bool Deque<T>::base_iterator<is_constant>::operator>(
+bool Deque<T, Hooks, Allocator>::base_iterator<is_constant>::operator>(
     const base_iterator& other) const {
   return other < *this;
 }
 
-template <typename T>
+template <typename T, typename Hooks, typename Allocator>
 template <bool is_constant>
-bool Deque<T>::base_iterator<is_constant>::operator<=(
+bool Deque<T, Hooks, Allocator>::base_iterator<is_constant>::operator<=(
     const base_iterator& other) const {
   return !(*this > other);
 }
 
-template <typename T>
+template <typename T, typename Hooks, typename Allocator>
 template <bool is_constant>
-bool Deque<T>::base_iterator<is_constant>::operator>=(
+bool Deque<T, Hooks, Allocator>::base_iterator<is_constant>::operator>=(
     const base_iterator& other) const {
   return !(*this < other);
 }
 
-template <typename T>
+template <typename T, typename Hooks, typename Allocator>
 template <bool is_constant>
-typename Deque<T>::template base_iterator<is_constant>&
-Deque<T>::base_iterator<is_constant>::operator+=(int shift) {
+typename Deque<T, Hooks, Allocator>::template base_iterator<is_constant>&
+Deque<T, Hooks, Allocator>::base_iterator<is_constant>::operator+=(int shift) {
   difference_type new_position = position_;
   new_position += shift;
   bucket_ += new_position / (difference_type)Bucket::size;
@@ -416,51 +558,57 @@ Deque<T>::base_iterator<is_constant>::operator+=(int shift) {
   return *this;
 }
 
-template <typename T>
+template <typename T, typename Hooks, typename Allocator>
 template <bool is_constant>
-typename Deque<T>::template base_iterator<is_constant>&
-Deque<T>::base_iterator<is_constant>::operator-=(int shift) {
+typename Deque<T, Hooks, Allocator>::template base_iterator<is_constant>&
+Deque<T, Hooks, Allocator>::base_iterator<is_constant>::operator-=(int shift) {
   (*this) += -shift;
   return *this;
 }
 
-template <typename T>
+template <typename T, typename Hooks, typename Allocator>
 template <bool is_constant>
-typename Deque<T>::template base_iterator<is_constant>
-Deque<T>::base_iterator<is_constant>::operator+(int shift) const {
+typename Deque<T, Hooks, Allocator>::template base_iterator<is_constant>
+Deque<T, Hooks, Allocator>::base_iterator<is_constant>::operator+(
+    int shift) const {
   base_iterator<is_constant> answer(*this);
   answer += shift;
   return answer;
 }
 
-template <typename T>
+template <typename T, typename Hooks, typename Allocator>
 template <bool is_constant>
-typename Deque<T>::template base_iterator<is_constant>
-Deque<T>::base_iterator<is_constant>::operator-(int shift) const {
+typename Deque<T, Hooks, Allocator>::template base_iterator<is_constant>
+Deque<T, Hooks, Allocator>::base_iterator<is_constant>::operator-(
+    int shift) const {
   base_iterator<is_constant> answer(*this);
   answer -= shift;
   return answer;
 }
 
-template <typename T>
+template <typename T, typename Hooks, typename Allocator>
 template <bool is_constant>
-typename Deque<T>::template base_iterator<is_constant>::difference_type
-Deque<T>::base_iterator<is_constant>::operator-(
-    const base_iterator<is_constant>& other) const {
+auto Deque<T, Hooks, Allocator>::base_iterator<is_constant>::operator-(
+    const base_iterator<is_constant>& other) const -> difference_type {
   difference_type answer = (bucket_ - other.bucket_) * Bucket::size +
                            (difference_type)(position_) -
                            (difference_type)(other.position_);
   return answer;
 }
 
-template <typename T>
-template <bool is_constant>
-Deque<T>::base_iterator<is_constant>::operator base_iterator<true>() const {
-  return base_iterator<true>(bucket_, position_);
+template <typename T, typename Hooks, typename Allocator>
+void Deque<T, Hooks, Allocator>::push_back(const T& value) {
+  append(value);
+}
+
+template <typename T, typename Hooks, typename Allocator>
+void Deque<T, Hooks, Allocator>::push_back(T&& value) {
+  append(std::move(value));
 }
 
-template <typename T>
-void Deque<T>::push_back(const T& value) {
+template <typename T, typename Hooks, typename Allocator>
+template <typename Value>
+void Deque<T, Hooks, Allocator>::append(Value&& value) {
   auto pos = get_rbegin();
   ++pos.second;
   if (pos.second == Bucket::size) {
@@ -470,31 +618,37 @@ void Deque<T>::push_back(const T& value) {
   if (pos.first == bucket_quantity_ - 1 && pos.second == Bucket::size - 1) {
     Bucket* new_buckets = get_new_buckets(0);
     try {
-      new (new_buckets[pos.first].elements_ + pos.second) T(value);
+      element_allocator_traits::construct(
+          allocator_, new_buckets[pos.first].elements_ + pos.second,
+          std::forward<Value>(value));
     } catch (...) {
-      delete[] new_buckets;
+      free_buckets(new_buckets, bucket_quantity_ << 1);
       throw;
     }
-    delete[] buckets_;
+    free_buckets(buckets_, bucket_quantity_);
     buckets_ = new_buckets;
     bucket_quantity_ <<= 1;
   } else {
-    new (buckets_[pos.first].elements_ + pos.second) T(value);
+    element_allocator_traits::construct(
+        allocator_, buckets_[pos.first].elements_ + pos.second,
+        std::forward<Value>(value));
   }
   ++size_;
 }
 
-template <typename T>
-void Deque<T>::push_front(const T& value) {
+template <typename T, typename Hooks, typename Allocator>
+void Deque<T, Hooks, Allocator>::push_front(const T& value) {
   if (begin_bucket_ == 1 && begin_index_ == 0) {
     Bucket* new_buckets = get_new_buckets(bucket_quantity_);
     try {
-      new (new_buckets[bucket_quantity_].elements_ + Bucket::size - 1) T(value);
+      element_allocator_traits::construct(
+          allocator_,
+          new_buckets[bucket_quantity_].elements_ + Bucket::size - 1, value);
     } catch (...) {
-      delete[] new_buckets;
+      free_buckets(new_buckets, bucket_quantity_ << 1);
       throw;
     }
-    delete[] buckets_;
+    free_buckets(buckets_, bucket_quantity_);
     buckets_ = new_buckets;
     begin_bucket_ = bucket_quantity_;
     begin_index_ = Bucket::size - 1;
@@ -506,15 +660,17 @@ void Deque<T>::push_front(const T& value) {
       --begin_bucket_;
       begin_index_ = Bucket::size - 1;
     }
-    new (buckets_[begin_bucket_].elements_ + begin_index_) T(value);
+    element_allocator_traits::construct(
+        allocator_, buckets_[begin_bucket_].elements_ + begin_index_, value);
   }
   ++size_;
 }
 
-template <typename T>
-void Deque<T>::pop_back() {
+template <typename T, typename Hooks, typename Allocator>
+void Deque<T, Hooks, Allocator>::pop_back() {
   auto pos = get_rbegin();
-  (buckets_[pos.first].elements_ + pos.second)->~T();
+  element_allocator_traits::destroy(allocator_,
+                                    buckets_[pos.first].elements_ + pos.second);
   --size_;
   if (size_ == 0) {
     begin_index_ = 0;
@@ -522,9 +678,10 @@ void Deque<T>::pop_back() {
   }
 }
 
-template <typename T>
-void Deque<T>::pop_front() {
-  (buckets_[begin_bucket_].elements_ + begin_index_)->~T();
+template <typename T, typename Hooks, typename Allocator>
+void Deque<T, Hooks, Allocator>::pop_front() {
+  element_allocator_traits::destroy(
+      allocator_, buckets_[begin_bucket_].elements_ + begin_index_);
   ++begin_index_;
   if (begin_index_ == Bucket::size) {
     begin_index_ = 0;
@@ -537,107 +694,119 @@ void Deque<T>::pop_front() {
   }
 }
 
-template <typename T>
-typename Deque<T>::iterator Deque<T>::begin() {
+template <typename T, typename Hooks, typename Allocator>
+typename Deque<T, Hooks, Allocator>::iterator
+Deque<T, Hooks, Allocator>::begin() {
   return iterator(buckets_ + begin_bucket_, begin_index_);
 }
 
-template <typename T>
-typename Deque<T>::const_iterator Deque<T>::begin() const {
+template <typename T, typename Hooks, typename Allocator>
+typename Deque<T, Hooks, Allocator>::const_iterator
+Deque<T, Hooks, Allocator>::begin() const {
   return const_iterator(buckets_ + begin_bucket_, begin_index_);
 }
 
-template <typename T>
-typename Deque<T>::const_iterator Deque<T>::cbegin() const {
+template <typename T, typename Hooks, typename Allocator>
+typename Deque<T, Hooks, Allocator>::const_iterator
+Deque<T, Hooks, Allocator>::cbegin() const {
   return const_iterator(buckets_ + begin_bucket_, begin_index_);
 }
 
-template <typename T>
-typename Deque<T>::iterator Deque<T>::end() {
+template <typename T, typename Hooks, typename Allocator>
+typename Deque<T, Hooks, Allocator>::iterator
+Deque<T, Hooks, Allocator>::end() {
   auto pos = get_end();
   return iterator(buckets_ + pos.first, pos.second);
 }
 
-template <typename T>
-typename Deque<T>::const_iterator Deque<T>::end() const {
+template <typename T, typename Hooks, typename Allocator>
+typename Deque<T, Hooks, Allocator>::const_iterator
+Deque<T, Hooks, Allocator>::end() const {
   auto pos = get_end();
   return const_iterator(buckets_ + pos.first, pos.second);
 }
 
-template <typename T>
-typename Deque<T>::const_iterator Deque<T>::cend() const {
+template <typename T, typename Hooks, typename Allocator>
+typename Deque<T, Hooks, Allocator>::const_iterator
+Deque<T, Hooks, Allocator>::cend() const {
   auto pos = get_end();
   return const_iterator(buckets_ + pos.first, pos.second);
 }
 
-template <typename T>
-typename Deque<T>::reverse_iterator Deque<T>::rbegin() {
+template <typename T, typename Hooks, typename Allocator>
+typename Deque<T, Hooks, Allocator>::reverse_iterator
+Deque<T, Hooks, Allocator>::rbegin() {
   auto pos = get_end();
   return reverse_iterator(iterator(buckets_ + pos.first, pos.second));
 }
 
-template <typename T>
-typename Deque<T>::const_reverse_iterator Deque<T>::rbegin() const {
+template <typename T, typename Hooks, typename Allocator>
+typename Deque<T, Hooks, Allocator>::const_reverse_iterator
+Deque<T, Hooks, Allocator>::rbegin() const {
   auto pos = get_end();
   return const_reverse_iterator(
       const_iterator(buckets_ + pos.first, pos.second));
 }
 
-template <typename T>
-typename Deque<T>::const_reverse_iterator Deque<T>::crbegin() const {
+template <typename T, typename Hooks, typename Allocator>
+typename Deque<T, Hooks, Allocator>::const_reverse_iterator
+Deque<T, Hooks, Allocator>::crbegin() const {
   auto pos = get_end();
   return const_reverse_iterator(
       const_iterator(buckets_ + pos.first, pos.second));
 }
 
-template <typename T>
-typename Deque<T>::reverse_iterator Deque<T>::rend() {
+template <typename T, typename Hooks, typename Allocator>
+typename Deque<T, Hooks, Allocator>::reverse_iterator
+Deque<T, Hooks, Allocator>::rend() {
   auto it = reverse_iterator(iterator(buckets_ + begin_bucket_, begin_index_));
   return it;
 }
 
-template <typename T>
-typename Deque<T>::const_reverse_iterator Deque<T>::rend() const {
+template <typename T, typename Hooks, typename Allocator>
+typename Deque<T, Hooks, Allocator>::const_reverse_iterator
+Deque<T, Hooks, Allocator>::rend() const {
   auto it = reverse_iterator(iterator(buckets_ + begin_bucket_, begin_index_));
   return const_reverse_iterator(it);
 }
 
-template <typename T>
-typename Deque<T>::const_reverse_iterator Deque<T>::crend() const {
+template <typename T, typename Hooks, typename Allocator>
+typename Deque<T, Hooks, Allocator>::const_reverse_iterator
+Deque<T, Hooks, Allocator>::crend() const {
   auto it = reverse_iterator(buckets_ + begin_bucket_, begin_index_);
   return const_reverse_iterator(it);
 }
 
-template <typename T>
-T& Deque<T>::operator[](size_t position) {
+template <typename T, typename Hooks, typename Allocator>
+T& Deque<T, Hooks, Allocator>::operator[](size_t position) {
   position += begin_bucket_ * Bucket::size + begin_index_;
   return buckets_[bucket_index(position)][in_bucket_index(position)];
 }
 
-template <typename T>
-const T& Deque<T>::operator[](size_t position) const {
+template <typename T, typename Hooks, typename Allocator>
+const T& Deque<T, Hooks, Allocator>::operator[](size_t position) const {
   position += begin_bucket_ * Bucket::size + begin_index_;
   return buckets_[bucket_index(position)][in_bucket_index(position)];
 }
 
-template <typename T>
-T& Deque<T>::at(size_t position) {
+template <typename T, typename Hooks, typename Allocator>
+T& Deque<T, Hooks, Allocator>::at(size_t position) {
   if (position >= size_) {
     throw std::out_of_range("Too big number");
   }
   return (*this)[position];
 }
 
-template <typename T>
-const T& Deque<T>::at(size_t position) const {
+template <typename T, typename Hooks, typename Allocator>
+const T& Deque<T, Hooks, Allocator>::at(size_t position) const {
   if (position >= size_) {
     throw std::out_of_range("Too big number");
   }
   return (*this)[position];
 }
 
-template <typename T>
-void Deque<T>::insert(iterator it, const T& value) {
+template <typename T, typename Hooks, typename Allocator>
+void Deque<T, Hooks, Allocator>::insert(iterator it, const T& value) {
   auto pos = get_position(it);
   pos.first -= begin_bucket_;
   push_back(value);
@@ -649,8 +818,8 @@ void Deque<T>::insert(iterator it, const T& value) {
   buckets_[begin_bucket_ + pos.first][pos.second] = value;
 }
 
-template <typename T>
-void Deque<T>::erase(iterator it) {
+template <typename T, typename Hooks, typename Allocator>
+void Deque<T, Hooks, Allocator>::erase(iterator it) {
   auto iter2 = it + 1;
   for (; iter2 < end(); ++it, ++iter2) {
     (*it) = (*iter2);
@@ -703,6 +703,35 @@ namespace TestsByUnrealf1 {
 
 } // namespace TestsByUnrealf1
 
+void testAllocationStats() {
+    static_assert(sizeof(Deque<int>) == sizeof(Deque<int, DequeNoHooks>));
+
+    {
+        Deque<int, DequeAllocationStats> d;
+        const auto& stats = d.hooks();
+        assert(stats.map_growths == 0);
+        assert(stats.bytes_held == d.memory_usage());
+
+        for (int i = 0; i < 10'000; ++i) {
+            d.push_back(i);
+            d.push_front(i);
+        }
+        assert(stats.map_growths > 0);
+        assert(stats.bytes_held == d.memory_usage());
+        assert(stats.peak_bytes >= stats.bytes_held);
+        assert(stats.chunk_allocations - stats.chunk_deallocations
+               == d.memory_usage() / (sizeof(int*) + 32 * sizeof(int)));
+
+        Deque<int, DequeAllocationStats> copy;
+        copy = d;
+        assert(copy.hooks().bytes_held == copy.memory_usage());
+        assert(d.hooks().bytes_held == d.memory_usage());
+    }
+
+    Deque<int, DequeAllocationStats> empty;
+    assert(empty.memory_usage() == 2 * (sizeof(int*) + 32 * sizeof(int)));
+}
+
 int main() {
     
     // static_assert(!std::is_same_v<std::deque<TestsByMesyarik::VerySpecialType>,
@@ -734,6 +763,8 @@ int main() {
     TestsByUnrealf1::testExceptions();
     //TestsByUnrealf1::testStrongGuarantee();
 
+    testAllocationStats();
+
     std::cout << 0;
 }
 
@@ -0,0 +1,132 @@
+#pragma once
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+#include "deque.h"
+
+template <typename T, typename Compare = std::less<T>, size_t D = 4>
+class PriorityQueue {
+  static_assert(D >= 2, "heap arity must be at least 2");
+
+ private:
+  Deque<T> heap_;
+  [[no_unique_address]] Compare compare_;
+
+  static size_t parent(size_t index) {
+    return (index - 1) / D;
+  }
+  static size_t first_child(size_t index) {
+    return index * D + 1;
+  }
+
+  void sift_up(size_t index);
+  void sift_down(size_t index);
+
+ public:
+  PriorityQueue() = default;
+  explicit PriorityQueue(const Compare& compare)
+      : compare_(compare) {
+  }
+
+  size_t size() const {
+    return heap_.size();
+  }
+
+  bool empty() const {
+    return heap_.size() == 0;
+  }
+
+  const T& top() const {
+    return heap_[0];
+  }
+
+  void push(const T& value);
+  void push(T&& value);
+  void pop();
+
+  template <typename InputIterator>
+  void push_bulk(InputIterator first, InputIterator last);
+};
+
+template <typename T, typename Compare, size_t D>
+void PriorityQueue<T, Compare, D>::sift_up(size_t index) {
+  T value = std::move(heap_[index]);
+  while (index > 0 && compare_(heap_[parent(index)], value)) {
+    heap_[index] = std::move(heap_[parent(index)]);
+    index = parent(index);
+  }
+  heap_[index] = std::move(value);
+}
+
+template <typename T, typename Compare, size_t D>
+void PriorityQueue<T, Compare, D>::sift_down(size_t index) {
+  size_t count = heap_.size();
+  T value = std::move(heap_[index]);
+  while (first_child(index) < count) {
+    size_t child = first_child(index);
+    size_t best = child;
+    T* best_value = &heap_[child];
+    size_t last_child = std::min(child + D, count);
+    for (++child; child < last_child; ++child) {
+      T* child_value = &heap_[child];
+      if (compare_(*best_value, *child_value)) {
+        best = child;
+        best_value = child_value;
+      }
+    }
+    if (!compare_(value, *best_value)) {
+      break;
+    }
+    heap_[index] = std::move(*best_value);
+    index = best;
+  }
+  heap_[index] = std::move(value);
+}
+
+template <typename T, typename Compare, size_t D>
+void PriorityQueue<T, Compare, D>::push(const T& value) {
+  heap_.push_back(value);
+  sift_up(heap_.size() - 1);
+}
+
+template <typename T, typename Compare, size_t D>
+void PriorityQueue<T, Compare, D>::push(T&& value) {
+  heap_.push_back(std::move(value));
+  sift_up(heap_.size() - 1);
+}
+
+template <typename T, typename Compare, size_t D>
+void PriorityQueue<T, Compare, D>::pop() {
+  size_t last = heap_.size() - 1;
+  if (last > 0) {
+    heap_[0] = std::move(heap_[last]);
+  }
+  heap_.pop_back();
+  if (last > 1) {
+    sift_down(0);
+  }
+}
+
+template <typename T, typename Compare, size_t D>
+template <typename InputIterator>
+void PriorityQueue<T, Compare, D>::push_bulk(InputIterator first,
+                                            InputIterator last) {
+  size_t old_size = heap_.size();
+  for (; first != last; ++first) {
+    heap_.push_back(*first);
+  }
+  size_t count = heap_.size();
+  if (count - old_size < old_size) {
+    for (size_t i = old_size; i < count; ++i) {
+      sift_up(i);
+    }
+    return;
+  }
+  if (count < 2) {
+    return;
+  }
+  for (size_t i = parent(count - 1) + 1; i > 0; --i) {
+    sift_down(i - 1);
+  }
+}
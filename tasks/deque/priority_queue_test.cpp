@@ -0,0 +1,209 @@
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <queue>
+#include <random>
+#include <vector>
+
+#include "priority_queue.h"
+
+#ifndef NO_TEST
+
+// NOLINTBEGIN
+
+template <size_t D, typename Compare = std::less<int>>
+void TestHeapOrder(Compare compare = Compare()) {
+    std::mt19937 gen(D);
+    std::vector<int> values(10'000);
+    for (auto& x : values) {
+        x = gen() % 1000;
+    }
+
+    PriorityQueue<int, Compare, D> queue(compare);
+    assert(queue.empty());
+    for (int x : values) {
+        queue.push(x);
+    }
+    assert(queue.size() == values.size());
+
+    std::sort(values.begin(), values.end(), [&](int a, int b) { return compare(b, a); });
+    for (int x : values) {
+        assert(queue.top() == x);
+        queue.pop();
+    }
+    assert(queue.empty());
+}
+
+template <size_t D>
+void TestPushBulk() {
+    std::mt19937 gen(42);
+    std::vector<int> values(5'000);
+    for (auto& x : values) {
+        x = gen();
+    }
+
+    PriorityQueue<int, std::less<int>, D> queue;
+    queue.push_bulk(values.begin(), values.end());
+    queue.push(gen());
+    // a small batch on top of a big heap goes through sift_up
+    queue.push_bulk(values.begin(), values.begin() + 10);
+    // a batch larger than the heap is heapified bottom-up
+    std::vector<int> more(20'000);
+    for (auto& x : more) {
+        x = gen();
+    }
+    queue.push_bulk(more.begin(), more.end());
+    assert(queue.size() == 25'011);
+
+    int previous = queue.top();
+    while (!queue.empty()) {
+        assert(queue.top() <= previous);
+        previous = queue.top();
+        queue.pop();
+    }
+
+    PriorityQueue<int> single;
+    single.push_bulk(values.begin(), values.begin() + 1);
+    assert(single.top() == values[0]);
+}
+
+template <typename Queue>
+long long RunQueue(Queue& queue, const std::vector<int>& values, long long& checksum) {
+    using namespace std::chrono;
+    auto start = high_resolution_clock::now();
+    for (size_t i = 0; i < values.size(); ++i) {
+        queue.push(values[i]);
+        if (i % 3 == 2) {
+            checksum += queue.top();
+            queue.pop();
+        }
+    }
+    while (!queue.empty()) {
+        checksum += queue.top();
+        queue.pop();
+    }
+    return duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+}
+
+struct CopyCounter {
+    static size_t copies;
+    int key = 0;
+
+    CopyCounter(int key) : key(key) {}
+    CopyCounter(const CopyCounter& other) : key(other.key) {
+        ++copies;
+    }
+    CopyCounter(CopyCounter&&) = default;
+    CopyCounter& operator=(const CopyCounter& other) {
+        key = other.key;
+        ++copies;
+        return *this;
+    }
+    CopyCounter& operator=(CopyCounter&&) = default;
+
+    bool operator<(const CopyCounter& other) const {
+        return key < other.key;
+    }
+};
+
+size_t CopyCounter::copies = 0;
+
+struct ByPointee {
+    bool operator()(const std::unique_ptr<int>& a, const std::unique_ptr<int>& b) const {
+        return *a < *b;
+    }
+};
+
+void TestMoveOnly() {
+    std::mt19937 gen(28);
+    PriorityQueue<CopyCounter, std::less<CopyCounter>, 3> counted;
+    for (int i = 0; i < 10'000; ++i) {
+        counted.push(CopyCounter(gen() % 1'000));
+    }
+    int previous = counted.top().key;
+    while (!counted.empty()) {
+        assert(counted.top().key <= previous);
+        previous = counted.top().key;
+        counted.pop();
+    }
+    assert(CopyCounter::copies == 0);
+
+    PriorityQueue<std::unique_ptr<int>, ByPointee> pointers;
+    for (int i = 0; i < 1'000; ++i) {
+        pointers.push(std::make_unique<int>((i * 37) % 1'000));
+    }
+    for (int expected = 999; expected >= 0; --expected) {
+        assert(*pointers.top() == expected);
+        pointers.pop();
+    }
+    assert(pointers.empty());
+}
+
+void TestPerformance() {
+    std::mt19937 gen(7);
+    std::vector<int> values(3'000'000);
+    for (auto& x : values) {
+        x = gen() % 1'000'000'000;
+    }
+
+    long long std_sum = 0;
+    std::priority_queue<int> std_queue;
+    auto std_time = RunQueue(std_queue, values, std_sum);
+
+    long long binary_sum = 0;
+    PriorityQueue<int, std::less<int>, 2> binary;
+    auto binary_time = RunQueue(binary, values, binary_sum);
+
+    long long quad_sum = 0;
+    PriorityQueue<int, std::less<int>, 4> quad;
+    auto quad_time = RunQueue(quad, values, quad_sum);
+
+    assert(std_sum == binary_sum);
+    assert(std_sum == quad_sum);
+
+    using namespace std::chrono;
+    auto start = high_resolution_clock::now();
+    PriorityQueue<int> bulk;
+    bulk.push_bulk(values.begin(), values.end());
+    auto bulk_time = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+    assert(bulk.top() == *std::max_element(values.begin(), values.end()));
+
+    std::cerr << " std::priority_queue: " << std_time << " ms, PriorityQueue<2>: " << binary_time
+              << " ms, PriorityQueue<4>: " << quad_time << " ms, push_bulk: " << bulk_time
+              << " ms" << std::endl;
+}
+
+int main() {
+    TestHeapOrder<2>();
+    TestHeapOrder<3>();
+    TestHeapOrder<4>();
+    TestHeapOrder<8>();
+    TestHeapOrder<4, std::greater<int>>();
+    std::cerr << "Test 1 (heap order) passed." << std::endl;
+
+    TestPushBulk<2>();
+    TestPushBulk<4>();
+    TestPushBulk<5>();
+    std::cerr << "Test 2 (push_bulk) passed." << std::endl;
+
+    TestMoveOnly();
+    std::cerr << "Test 3 (moves instead of copies) passed." << std::endl;
+
+    TestPerformance();
+    std::cerr << "Test 4 (performance) passed." << std::endl;
+
+    std::cout << 0;
+}
+
+// NOLINTEND
+
+#else
+
+int main() {
+    std::cerr << "Tests are turned off!\n";
+}
+
+#endif
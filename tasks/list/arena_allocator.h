@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+
+#include "stackstorage.h"
+
+template <typename T, typename Arena>
+class ArenaAllocator {
+ private:
+  Arena* arena_;
+
+  template <typename U, typename OtherArena>
+  friend class ArenaAllocator;
+
+ public:
+  using value_type = T;
+  using partial_deallocation = allows_partial_deallocation<Arena>;
+
+  ArenaAllocator() = delete;
+  ArenaAllocator(Arena& arena)
+      : arena_(&arena) {
+  }
+
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U, Arena>& other)
+      : arena_(other.arena_) {
+  }
+
+  template <typename U>
+  struct rebind {
+    using other = ArenaAllocator<U, Arena>;
+  };
+
+  Arena& arena() const {
+    return *arena_;
+  }
+
+  T* allocate(size_t n) {
+    return arena_->template allocate<T>(n);
+  }
+
+  void deallocate(T* ptr, size_t n) {
+    arena_->deallocate(ptr, n);
+  }
+
+  template <typename U>
+  bool operator==(const ArenaAllocator<U, Arena>& other) const {
+    return arena_ == other.arena_;
+  }
+
+  template <typename U>
+  bool operator!=(const ArenaAllocator<U, Arena>& other) const {
+    return !(*this == other);
+  }
+};
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+
+template <typename Arena>
+class ArenaResource : public std::pmr::memory_resource {
+ private:
+  template <size_t Alignment>
+  struct alignas(Alignment) Chunk {
+    unsigned char bytes[Alignment];
+  };
+
+  static const size_t max_alignment = 64;
+
+  Arena* arena_;
+
+  template <size_t Alignment>
+  void* allocate_aligned(size_t bytes, size_t alignment);
+
+  template <size_t Alignment>
+  void deallocate_aligned(void* ptr, size_t bytes, size_t alignment);
+
+ protected:
+  void* do_allocate(size_t bytes, size_t alignment) override {
+    return allocate_aligned<1>(bytes, alignment);
+  }
+
+  void do_deallocate(void* ptr, size_t bytes, size_t alignment) override {
+    deallocate_aligned<1>(ptr, bytes, alignment);
+  }
+
+  bool do_is_equal(
+      const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+
+ public:
+  ArenaResource(Arena& arena)
+      : arena_(&arena) {
+  }
+  ArenaResource(const ArenaResource&) = delete;
+  ArenaResource& operator=(const ArenaResource&) = delete;
+
+  Arena& arena() const {
+    return *arena_;
+  }
+};
+
+template <typename Arena>
+template <size_t Alignment>
+void* ArenaResource<Arena>::allocate_aligned(size_t bytes, size_t alignment) {
+  if constexpr (Alignment > max_alignment) {
+    throw std::bad_alloc();
+  } else {
+    if (alignment > Alignment) {
+      return allocate_aligned<Alignment * 2>(bytes, alignment);
+    }
+    size_t count = (bytes + Alignment - 1) / Alignment;
+    return arena_->template allocate<Chunk<Alignment>>(count);
+  }
+}
+
+template <typename Arena>
+template <size_t Alignment>
+void ArenaResource<Arena>::deallocate_aligned(void* ptr, size_t bytes,
+                                              size_t alignment) {
+  if constexpr (Alignment <= max_alignment) {
+    if (alignment > Alignment) {
+      deallocate_aligned<Alignment * 2>(ptr, bytes, alignment);
+      return;
+    }
+    size_t count = (bytes + Alignment - 1) / Alignment;
+    arena_->deallocate(static_cast<Chunk<Alignment>*>(ptr), count);
+  }
+}
@@ -0,0 +1,192 @@
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory_resource>
+#include <new>
+#include <string>
+
+#include "../deque/deque.h"
+#include "arena_resource.h"
+#include "monotonic_arena.h"
+#include "pool_allocator.h"
+#include "stackallocator.h"
+
+#ifndef NO_TEST
+
+// NOLINTBEGIN
+
+constexpr size_t STORAGE_SIZE = 100'000'000;
+StackStorage<STORAGE_SIZE> STATIC_STORAGE;
+StackStorage<STORAGE_SIZE> PMR_STORAGE;
+PoolStorage<STORAGE_SIZE> POOL_STORAGE;
+
+void TestAlignment() {
+    StackStorage<STORAGE_SIZE>& storage = PMR_STORAGE;
+    ArenaResource<StackStorage<STORAGE_SIZE>> resource(storage);
+    std::pmr::memory_resource& base = resource;
+
+    for (size_t alignment = 1; alignment <= 64; alignment *= 2) {
+        void* ptr = base.allocate(3, alignment);
+        assert(reinterpret_cast<uintptr_t>(ptr) % alignment == 0);
+    }
+    size_t used = storage.used();
+    void* last = base.allocate(100, 16);
+    base.deallocate(last, 100, 16);
+    assert(storage.used() == used);
+
+    bool thrown = false;
+    try {
+        static_cast<void>(base.allocate(8, 128));
+    } catch (const std::bad_alloc&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    ArenaResource<StackStorage<STORAGE_SIZE>> other(storage);
+    assert(base.is_equal(resource) && !base.is_equal(other));
+    assert(&resource.arena() == &storage);
+}
+
+template <typename Arena>
+void CheckContainers(Arena& arena) {
+    ArenaResource<Arena> resource(arena);
+    std::pmr::polymorphic_allocator<std::string> alloc(&resource);
+
+    List<std::string, std::pmr::polymorphic_allocator<std::string>> lst(alloc);
+    for (int i = 0; i < 1'000; ++i) {
+        lst.push_back(std::to_string(i));
+    }
+    lst.emplace_front("front");
+    assert(lst.size() == 1'001 && *lst.begin() == "front" && *lst.rbegin() == "999");
+    assert(lst.get_allocator().resource() == &resource);
+
+    // copies follow the polymorphic_allocator rules: the copy goes to the default resource,
+    // assignment keeps the resource of the destination
+    auto copy = lst;
+    assert(copy.get_allocator().resource() == std::pmr::get_default_resource());
+    List<std::string, std::pmr::polymorphic_allocator<std::string>> assigned(alloc);
+    assigned = copy;
+    assert(assigned.size() == lst.size() && assigned.get_allocator().resource() == &resource);
+    assigned = std::move(copy);
+    assert(assigned.size() == lst.size() && *assigned.begin() == "front");
+
+    Deque<int, DequeNoHooks, std::pmr::polymorphic_allocator<int>> deque(&resource);
+    for (int i = 0; i < 10'000; ++i) {
+        deque.push_back(i);
+        deque.push_front(-i);
+    }
+    assert(deque.size() == 20'000 && deque[0] == -9'999 && deque[19'999] == 9'999);
+    assert(deque.get_allocator().resource() == &resource);
+    Deque<int, DequeNoHooks, std::pmr::polymorphic_allocator<int>> other(5, 7, &resource);
+    other = deque;
+    assert(other.size() == deque.size() && other.get_allocator().resource() == &resource);
+}
+
+void TestContainers() {
+    size_t used = STATIC_STORAGE.used();
+    CheckContainers(STATIC_STORAGE);
+    assert(STATIC_STORAGE.used() > used);
+
+    MonotonicArena<4096> monotonic;
+    CheckContainers(monotonic);
+    assert(monotonic.block_count() > 0);
+
+    CheckContainers(POOL_STORAGE);
+    assert(POOL_STORAGE.used() > 0);
+}
+
+// Deque elements that take an allocator themselves must get the container's
+// resource, so with the default resource switched off nothing may fall back to it
+void TestAllocatorAwareElements() {
+    using Alloc = std::pmr::polymorphic_allocator<std::pmr::string>;
+    MonotonicArena<4096> monotonic;
+    ArenaResource<MonotonicArena<4096>> resource(monotonic);
+    std::pmr::memory_resource* previous = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+
+    const std::pmr::string long_value("a string too long for the small buffer", &resource);
+    Deque<std::pmr::string, DequeNoHooks, Alloc> deque(3, long_value, Alloc(&resource));
+    for (int i = 0; i < 1'000; ++i) {
+        deque.push_back(long_value);
+        deque.push_front(long_value);
+    }
+    Deque<std::pmr::string, DequeNoHooks, Alloc> assigned{Alloc(&resource)};
+    assigned = deque;
+    for (const auto& value : assigned) {
+        assert(value == long_value && value.get_allocator().resource() == &resource);
+    }
+    for (const auto& value : deque) {
+        assert(value.get_allocator().resource() == &resource);
+    }
+    deque.pop_back();
+    deque.pop_front();
+    assert(deque.size() == 2'001);
+
+    std::pmr::set_default_resource(previous);
+}
+
+void CompareDispatch() {
+    using namespace std::chrono;
+    using Static = StackAllocator<int, STORAGE_SIZE>;
+    using Polymorphic = std::pmr::polymorphic_allocator<int>;
+
+    const int size = 1'000'000;
+    const int rounds = 10;
+    ArenaResource<StackStorage<STORAGE_SIZE>> resource(PMR_STORAGE);
+
+    long long static_sum = 0;
+    long long polymorphic_sum = 0;
+    auto start = high_resolution_clock::now();
+    for (int round = 0; round < rounds; ++round) {
+        List<int, Static> lst{Static(STATIC_STORAGE)};
+        for (int i = 0; i < size; ++i) {
+            lst.push_back(i);
+        }
+        for (int x : lst) {
+            static_sum += x;
+        }
+    }
+    auto static_done = high_resolution_clock::now();
+    for (int round = 0; round < rounds; ++round) {
+        List<int, Polymorphic> lst{Polymorphic(&resource)};
+        for (int i = 0; i < size; ++i) {
+            lst.push_back(i);
+        }
+        for (int x : lst) {
+            polymorphic_sum += x;
+        }
+    }
+    auto polymorphic_done = high_resolution_clock::now();
+    assert(static_sum == polymorphic_sum);
+
+    std::cerr << " " << rounds << " x " << size << " push_back: StackAllocator "
+              << duration_cast<milliseconds>(static_done - start).count()
+              << " ms, polymorphic_allocator over ArenaResource "
+              << duration_cast<milliseconds>(polymorphic_done - static_done).count() << " ms" << std::endl;
+}
+
+int main() {
+    TestAlignment();
+    std::cerr << "Test 1 (alignment and equality of the resource) passed." << std::endl;
+
+    TestContainers();
+    std::cerr << "Test 2 (List and Deque with polymorphic_allocator over every arena) passed." << std::endl;
+
+    TestAllocatorAwareElements();
+    std::cerr << "Test 3 (uses-allocator construction of pmr::string elements) passed." << std::endl;
+
+    CompareDispatch();
+    std::cerr << "Test 4 (static vs virtual dispatch) passed." << std::endl;
+
+    std::cout << 0;
+}
+
+// NOLINTEND
+
+#else
+
+int main() {
+    std::cerr << "Tests are turned off!\n";
+}
+
+#endif
@@ -0,0 +1,390 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "mmap_storage.h"
+#include "monotonic_arena.h"
+#include "pool_allocator.h"
+#include "slab_allocator.h"
+#include "stackallocator.h"
+
+// Runs the same workloads over List and std::list for every allocator in the
+// tree and prints one JSON array with a record per container, allocator and
+// workload:
+//
+//   bench_allocators [size] [operations] [repetitions]
+//
+// ns_per_op is the best of the repetitions. allocations_per_op counts calls
+// into the allocator during the timed part, so batching shows up as less than
+// one. peak_bytes is the most memory the container held at once, arena_bytes
+// is what the arena itself had claimed by the end of the workload, while the
+// container was still alive.
+
+// NOLINTBEGIN
+
+constexpr size_t ARENA_SIZE = size_t(128) << 20;
+
+struct AllocationCounters {
+    size_t allocations = 0;
+    size_t live_bytes = 0;
+    size_t peak_bytes = 0;
+    std::function<long long()> footprint;
+    long long arena_bytes = -1;
+
+    void SampleArena() {
+        arena_bytes = std::max(arena_bytes, footprint());
+    }
+};
+
+template <typename T, typename Inner>
+class CountingAllocator {
+private:
+    using InnerAllocator = typename std::allocator_traits<Inner>::template rebind_alloc<T>;
+
+    InnerAllocator inner_;
+    AllocationCounters* counters_;
+
+    template <typename U, typename OtherInner>
+    friend class CountingAllocator;
+
+public:
+    using value_type = T;
+    using partial_deallocation = allows_partial_deallocation<InnerAllocator>;
+
+    CountingAllocator(const Inner& inner, AllocationCounters& counters)
+        : inner_(inner), counters_(&counters) {}
+
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U, Inner>& other)
+        : inner_(other.inner_), counters_(other.counters_) {}
+
+    T* allocate(size_t n) {
+        T* result = inner_.allocate(n);
+        ++counters_->allocations;
+        counters_->live_bytes += n * sizeof(T);
+        counters_->peak_bytes = std::max(counters_->peak_bytes, counters_->live_bytes);
+        return result;
+    }
+
+    void deallocate(T* ptr, size_t n) {
+        inner_.deallocate(ptr, n);
+        counters_->live_bytes -= n * sizeof(T);
+    }
+
+    template <typename U>
+    bool operator==(const CountingAllocator<U, Inner>& other) const {
+        return inner_ == other.inner_ && counters_ == other.counters_;
+    }
+
+    template <typename U>
+    bool operator!=(const CountingAllocator<U, Inner>& other) const {
+        return !(*this == other);
+    }
+};
+
+struct Measurement {
+    size_t operations = 0;
+    long long nanoseconds = 0;
+    size_t allocations = 0;
+};
+
+template <typename Clock = std::chrono::steady_clock>
+class Stopwatch {
+private:
+    typename Clock::time_point start_ = Clock::now();
+
+public:
+    long long elapsed() const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start_).count();
+    }
+};
+
+// push_back size elements and drop the container, operations / size times
+template <typename Container, typename Alloc>
+Measurement SequentialBuild(const Alloc& alloc, AllocationCounters& counters, size_t size,
+                            size_t operations) {
+    size_t rounds = std::max<size_t>(1, operations / size);
+    Stopwatch<> watch;
+    for (size_t round = 0; round < rounds; ++round) {
+        Container lst(alloc);
+        for (size_t i = 0; i < size; ++i) {
+            lst.push_back(static_cast<int>(i));
+        }
+        counters.SampleArena();
+    }
+    return {rounds * size, watch.elapsed(), counters.allocations};
+}
+
+// every operation erases a random element and inserts a new one before
+// another random element
+template <typename Container, typename Alloc>
+Measurement RandomInsertErase(const Alloc& alloc, AllocationCounters& counters, size_t size,
+                              size_t operations) {
+    std::mt19937 gen(49);
+    Container lst(alloc);
+    std::vector<typename Container::iterator> handles;
+    handles.reserve(size);
+    for (size_t i = 0; i < size; ++i) {
+        lst.push_back(static_cast<int>(i));
+        handles.push_back(std::prev(lst.end()));
+    }
+    std::vector<std::pair<size_t, size_t>> picks(operations);
+    for (auto& [victim, position] : picks) {
+        victim = gen() % size;
+        position = gen() % size;
+    }
+
+    counters.allocations = 0;
+    Stopwatch<> watch;
+    for (auto [victim, position] : picks) {
+        if (victim == position) {
+            position = (position + 1) % size;
+        }
+        lst.erase(handles[victim]);
+        auto before = handles[position];
+        lst.insert(before, static_cast<int>(victim));
+        handles[victim] = std::prev(before);
+    }
+    long long elapsed = watch.elapsed();
+    counters.SampleArena();
+    return {operations, elapsed, counters.allocations};
+}
+
+// queue of size elements, every operation pops the front and pushes the back
+template <typename Container, typename Alloc>
+Measurement FifoChurn(const Alloc& alloc, AllocationCounters& counters, size_t size,
+                      size_t operations) {
+    Container lst(alloc);
+    for (size_t i = 0; i < size; ++i) {
+        lst.push_back(static_cast<int>(i));
+    }
+
+    counters.allocations = 0;
+    Stopwatch<> watch;
+    for (size_t i = 0; i < operations; ++i) {
+        lst.pop_front();
+        lst.push_back(static_cast<int>(i));
+    }
+    long long elapsed = watch.elapsed();
+    counters.SampleArena();
+    return {operations, elapsed, counters.allocations};
+}
+
+// sums a list built in shuffled order, so the node order in memory differs
+// from the list order unless the allocator hands out neighbouring blocks
+template <typename Container, typename Alloc>
+Measurement Iteration(const Alloc& alloc, AllocationCounters& counters, size_t size,
+                      size_t operations) {
+    std::mt19937 gen(50);
+    Container lst(alloc);
+    for (size_t i = 0; i < size; ++i) {
+        auto position = lst.begin();
+        std::advance(position, i == 0 ? 0 : gen() % std::min<size_t>(i, 64));
+        lst.insert(position, static_cast<int>(i));
+    }
+
+    size_t passes = std::max<size_t>(1, operations / size);
+    counters.allocations = 0;
+    Stopwatch<> watch;
+    long long sum = 0;
+    for (size_t pass = 0; pass < passes; ++pass) {
+        for (int x : lst) {
+            sum += x;
+        }
+    }
+    long long elapsed = watch.elapsed();
+    if (sum != static_cast<long long>(passes) * static_cast<long long>(size * (size - 1) / 2)) {
+        std::abort();
+    }
+    counters.SampleArena();
+    return {passes * size, elapsed, counters.allocations};
+}
+
+struct SystemBackend {
+    static constexpr const char* name = "std::allocator";
+
+    std::allocator<int> allocator() {
+        return {};
+    }
+};
+
+struct StackBackend {
+    static constexpr const char* name = "StackAllocator";
+    std::unique_ptr<StackStorage<ARENA_SIZE>> arena{new StackStorage<ARENA_SIZE>};
+
+    StackAllocator<int, ARENA_SIZE> allocator() {
+        return StackAllocator<int, ARENA_SIZE>(*arena);
+    }
+};
+
+template <typename Arena>
+struct ArenaBackend {
+    std::unique_ptr<Arena> arena{new Arena};
+
+    ArenaAllocator<int, Arena> allocator() {
+        return ArenaAllocator<int, Arena>(*arena);
+    }
+};
+
+struct PoolBackend : ArenaBackend<PoolStorage<ARENA_SIZE>> {
+    static constexpr const char* name = "PoolAllocator";
+};
+
+struct MonotonicBackend : ArenaBackend<MonotonicArena<4096>> {
+    static constexpr const char* name = "MonotonicAllocator";
+};
+
+struct SlabBackend : ArenaBackend<SlabArena> {
+    static constexpr const char* name = "SlabAllocator";
+};
+
+struct MmapBackend : ArenaBackend<MmapStackStorage<ARENA_SIZE>> {
+    static constexpr const char* name = "MmapStackAllocator";
+};
+
+template <typename Backend>
+long long ArenaBytes(const Backend& backend) {
+    if constexpr (requires { backend.arena->bytes_reserved(); }) {
+        return static_cast<long long>(backend.arena->bytes_reserved());
+    } else if constexpr (requires { backend.arena->used(); }) {
+        return static_cast<long long>(backend.arena->used());
+    } else {
+        return -1;
+    }
+}
+
+struct Workload {
+    const char* name;
+    size_t operations;
+};
+
+class Report {
+private:
+    bool first_ = true;
+
+public:
+    Report() {
+        std::cout << "[";
+    }
+    ~Report() {
+        std::cout << "\n]" << std::endl;
+    }
+
+    void Begin(const char* container, const char* allocator, const char* workload, size_t size) {
+        std::cout << (first_ ? "\n" : ",\n") << "  {\"container\": \"" << container
+                  << "\", \"allocator\": \"" << allocator << "\", \"workload\": \"" << workload
+                  << "\", \"size\": " << size;
+        first_ = false;
+    }
+
+    void Result(const Measurement& best, size_t peak_bytes, long long arena_bytes) {
+        double operations = static_cast<double>(best.operations);
+        std::cout << ", \"operations\": " << best.operations
+                  << ", \"ns_per_op\": " << static_cast<double>(best.nanoseconds) / operations
+                  << ", \"allocations_per_op\": " << static_cast<double>(best.allocations) / operations
+                  << ", \"peak_bytes\": " << peak_bytes << ", \"arena_bytes\": ";
+        if (arena_bytes < 0) {
+            std::cout << "null}";
+        } else {
+            std::cout << arena_bytes << "}";
+        }
+    }
+
+    void Error(const char* what) {
+        std::cout << ", \"error\": \"" << what << "\"}";
+    }
+};
+
+template <template <typename, typename> class Container, typename Backend, typename Run>
+void Measure(Report& report, const char* container, const char* workload, Run run, size_t size,
+             size_t operations, size_t repetitions) {
+    report.Begin(container, Backend::name, workload, size);
+    Measurement best;
+    size_t peak_bytes = 0;
+    long long arena_bytes = -1;
+    try {
+        for (size_t i = 0; i < repetitions; ++i) {
+            Backend backend;
+            AllocationCounters counters;
+            counters.footprint = [&backend] { return ArenaBytes(backend); };
+            using Inner = decltype(backend.allocator());
+            using Alloc = CountingAllocator<int, Inner>;
+            Measurement current =
+                    run.template operator()<Container<int, Alloc>>(Alloc(backend.allocator(), counters), counters,
+                                                                 size, operations);
+            if (i == 0 || current.nanoseconds < best.nanoseconds) {
+                best = current;
+            }
+            peak_bytes = std::max(peak_bytes, counters.peak_bytes);
+            arena_bytes = std::max(arena_bytes, counters.arena_bytes);
+        }
+    } catch (const std::bad_alloc&) {
+        report.Error("bad_alloc");
+        return;
+    }
+    report.Result(best, peak_bytes, arena_bytes);
+}
+
+template <template <typename, typename> class Container, typename Backend>
+void MeasureAll(Report& report, const char* container, size_t size, size_t operations,
+                size_t repetitions) {
+    Measure<Container, Backend>(
+            report, container, "sequential_build",
+            []<typename C>(const auto& alloc, auto& counters, size_t n, size_t ops) {
+                return SequentialBuild<C>(alloc, counters, n, ops);
+            },
+            size, operations, repetitions);
+    Measure<Container, Backend>(
+            report, container, "random_insert_erase",
+            []<typename C>(const auto& alloc, auto& counters, size_t n, size_t ops) {
+                return RandomInsertErase<C>(alloc, counters, n, ops);
+            },
+            size, operations, repetitions);
+    Measure<Container, Backend>(
+            report, container, "fifo_churn",
+            []<typename C>(const auto& alloc, auto& counters, size_t n, size_t ops) {
+                return FifoChurn<C>(alloc, counters, n, ops);
+            },
+            size, operations, repetitions);
+    Measure<Container, Backend>(
+            report, container, "iteration",
+            []<typename C>(const auto& alloc, auto& counters, size_t n, size_t ops) {
+                return Iteration<C>(alloc, counters, n, ops);
+            },
+            size, operations, repetitions);
+}
+
+template <typename Backend>
+void MeasureBackend(Report& report, size_t size, size_t operations, size_t repetitions) {
+    MeasureAll<List, Backend>(report, "List", size, operations, repetitions);
+    MeasureAll<std::list, Backend>(report, "std::list", size, operations, repetitions);
+}
+
+int main(int argc, char** argv) {
+    size_t size = argc > 1 ? std::stoul(argv[1]) : 100'000;
+    size_t operations = argc > 2 ? std::stoul(argv[2]) : 1'000'000;
+    size_t repetitions = argc > 3 ? std::stoul(argv[3]) : 3;
+    if (size < 2 || operations == 0 || repetitions == 0) {
+        std::cerr << "usage: " << argv[0] << " [size >= 2] [operations] [repetitions]" << std::endl;
+        return 1;
+    }
+
+    Report report;
+    MeasureBackend<SystemBackend>(report, size, operations, repetitions);
+    MeasureBackend<StackBackend>(report, size, operations, repetitions);
+    MeasureBackend<PoolBackend>(report, size, operations, repetitions);
+    MeasureBackend<MonotonicBackend>(report, size, operations, repetitions);
+    MeasureBackend<SlabBackend>(report, size, operations, repetitions);
+    MeasureBackend<MmapBackend>(report, size, operations, repetitions);
+}
+
+// NOLINTEND
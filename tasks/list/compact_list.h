@@ -0,0 +1,512 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+template <typename T, typename Allocator = std::allocator<T>>
+class CompactList {
+ private:
+  struct Slot {
+    uint32_t next;
+    uint32_t previous;
+    alignas(T) unsigned char buffer[sizeof(T)];
+
+    T* value() {
+      return std::launder(reinterpret_cast<T*>(buffer));
+    }
+  };
+  using SlotAllocator =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<Slot>;
+  using slot_allocator_traits = typename std::allocator_traits<SlotAllocator>;
+
+  static constexpr uint32_t sentinel = 0;
+  static constexpr size_t max_slots = std::numeric_limits<uint32_t>::max();
+  static constexpr bool nothrow_move_assign =
+      slot_allocator_traits::propagate_on_container_move_assignment::value ||
+      slot_allocator_traits::is_always_equal::value;
+
+  [[no_unique_address]] SlotAllocator slot_allocator_;
+  Slot* slots_ = nullptr;
+  uint32_t capacity_ = 0;
+  uint32_t used_ = 0;
+  uint32_t free_head_ = sentinel;
+  uint32_t size_ = 0;
+
+  void grow(size_t capacity);
+  uint32_t acquire_slot();
+  void release_slot(uint32_t index);
+  void link_before(uint32_t position, uint32_t index);
+  void unlink(uint32_t index);
+  void steal(CompactList& other);
+  void release();
+
+  template <bool is_constant>
+  class base_iterator {
+   public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = std::conditional_t<is_constant, const T, T>;
+    using pointer = std::conditional_t<is_constant, const T*, T*>;
+    using reference = std::conditional_t<is_constant, const T&, T&>;
+    using difference_type = int;
+
+   private:
+    const CompactList* list_;
+    uint32_t index_;
+
+   public:
+    base_iterator() = delete;
+    base_iterator(const CompactList* list, uint32_t index)
+        : list_(list),
+          index_(index) {
+    }
+
+    base_iterator& operator++() {
+      index_ = list_->slots_[index_].next;
+      return *this;
+    }
+    base_iterator operator++(int) {
+      base_iterator result = *this;
+      ++(*this);
+      return result;
+    }
+
+    base_iterator& operator--() {
+      index_ = list_->slots_[index_].previous;
+      return *this;
+    }
+    base_iterator operator--(int) {
+      base_iterator result = *this;
+      --(*this);
+      return result;
+    }
+
+    bool operator==(const base_iterator& other) const {
+      return index_ == other.index_ && list_ == other.list_;
+    }
+    bool operator!=(const base_iterator& other) const {
+      return !(*this == other);
+    }
+
+    operator base_iterator<true>() const {
+      return base_iterator<true>(list_, index_);
+    }
+
+    pointer operator->() const {
+      return list_->slots_[index_].value();
+    }
+
+    reference operator*() const {
+      return *list_->slots_[index_].value();
+    }
+
+    friend class CompactList<T, Allocator>;
+  };
+
+ public:
+  using iterator = base_iterator<false>;
+  using const_iterator = base_iterator<true>;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  CompactList(const Allocator& alloc)
+      : slot_allocator_(alloc) {
+  }
+  CompactList(size_t size, const T& value, const Allocator& alloc);
+  CompactList()
+      : slot_allocator_() {
+  }
+  CompactList(size_t size, const T& value);
+  CompactList(const CompactList& other);
+  CompactList(CompactList&& other) noexcept;
+  CompactList& operator=(const CompactList& other);
+  CompactList& operator=(CompactList&& other) noexcept(nothrow_move_assign);
+  ~CompactList();
+
+  void clear();
+
+  size_t size() const {
+    return size_;
+  }
+
+  bool empty() const {
+    return size_ == 0;
+  }
+
+  size_t capacity() const {
+    return capacity_ == 0 ? 0 : capacity_ - 1;
+  }
+
+  size_t memory_usage() const {
+    return capacity_ * sizeof(Slot);
+  }
+
+  void reserve(size_t count);
+
+  Allocator get_allocator() const {
+    return Allocator(slot_allocator_);
+  }
+
+  void push_back(const T& value);
+  void push_back(T&& value);
+  void push_front(const T& value);
+  void push_front(T&& value);
+  void pop_back();
+  void pop_front();
+
+  template <typename... Args>
+  void emplace_back(Args&&... args);
+  template <typename... Args>
+  void emplace_front(Args&&... args);
+
+  iterator begin() {
+    return iterator(this, slots_ == nullptr ? sentinel : slots_[0].next);
+  }
+  const_iterator begin() const {
+    return const_iterator(this, slots_ == nullptr ? sentinel : slots_[0].next);
+  }
+  const_iterator cbegin() const {
+    return begin();
+  }
+  iterator end() {
+    return iterator(this, sentinel);
+  }
+  const_iterator end() const {
+    return const_iterator(this, sentinel);
+  }
+  const_iterator cend() const {
+    return end();
+  }
+
+  reverse_iterator rbegin() {
+    return reverse_iterator(end());
+  }
+  const_reverse_iterator rbegin() const {
+    return const_reverse_iterator(end());
+  }
+  const_reverse_iterator crbegin() const {
+    return rbegin();
+  }
+  reverse_iterator rend() {
+    return reverse_iterator(begin());
+  }
+  const_reverse_iterator rend() const {
+    return const_reverse_iterator(begin());
+  }
+  const_reverse_iterator crend() const {
+    return rend();
+  }
+
+  void insert(const_iterator, const T&);
+  void insert(const_iterator, T&&);
+  void erase(const_iterator);
+
+  template <typename... Args>
+  void emplace(const_iterator, Args&&...);
+};
+
+template <typename T, typename Allocator>
+void CompactList<T, Allocator>::grow(size_t capacity) {
+  if (capacity > max_slots || capacity == capacity_) {
+    throw std::length_error("CompactList cannot index more than 2^32 slots");
+  }
+  Slot* slots = slot_allocator_traits::allocate(slot_allocator_, capacity);
+  uint32_t moved = sentinel;
+  if (slots_ == nullptr) {
+    slots[sentinel].next = sentinel;
+    slots[sentinel].previous = sentinel;
+    used_ = 1;
+  } else {
+    try {
+      for (moved = slots_[sentinel].next; moved != sentinel;
+           moved = slots_[moved].next) {
+        slot_allocator_traits::construct(
+            slot_allocator_, slots[moved].value(),
+            std::move_if_noexcept(*slots_[moved].value()));
+      }
+    } catch (...) {
+      for (uint32_t i = slots_[sentinel].next; i != moved;
+           i = slots_[i].next) {
+        slot_allocator_traits::destroy(slot_allocator_, slots[i].value());
+      }
+      slot_allocator_traits::deallocate(slot_allocator_, slots, capacity);
+      throw;
+    }
+    for (uint32_t i = 0; i < used_; ++i) {
+      slots[i].next = slots_[i].next;
+      slots[i].previous = slots_[i].previous;
+    }
+    for (uint32_t i = slots_[sentinel].next; i != sentinel;
+         i = slots_[i].next) {
+      slot_allocator_traits::destroy(slot_allocator_, slots_[i].value());
+    }
+    slot_allocator_traits::deallocate(slot_allocator_, slots_, capacity_);
+  }
+  slots_ = slots;
+  capacity_ = static_cast<uint32_t>(capacity);
+}
+
+template <typename T, typename Allocator>
+uint32_t CompactList<T, Allocator>::acquire_slot() {
+  if (free_head_ != sentinel) {
+    uint32_t index = free_head_;
+    free_head_ = slots_[index].next;
+    return index;
+  }
+  if (used_ == capacity_) {
+    grow(capacity_ < 8 ? 16 : std::min(size_t{capacity_} * 2, max_slots));
+  }
+  return used_++;
+}
+
+template <typename T, typename Allocator>
+void CompactList<T, Allocator>::release_slot(uint32_t index) {
+  slots_[index].next = free_head_;
+  free_head_ = index;
+}
+
+template <typename T, typename Allocator>
+void CompactList<T, Allocator>::link_before(uint32_t position,
+                                            uint32_t index) {
+  uint32_t previous = slots_[position].previous;
+  slots_[index].previous = previous;
+  slots_[index].next = position;
+  slots_[previous].next = index;
+  slots_[position].previous = index;
+}
+
+template <typename T, typename Allocator>
+void CompactList<T, Allocator>::unlink(uint32_t index) {
+  slots_[slots_[index].previous].next = slots_[index].next;
+  slots_[slots_[index].next].previous = slots_[index].previous;
+}
+
+template <typename T, typename Allocator>
+void CompactList<T, Allocator>::steal(CompactList& other) {
+  slots_ = std::exchange(other.slots_, nullptr);
+  capacity_ = std::exchange(other.capacity_, 0);
+  used_ = std::exchange(other.used_, 0);
+  free_head_ = std::exchange(other.free_head_, sentinel);
+  size_ = std::exchange(other.size_, 0);
+}
+
+template <typename T, typename Allocator>
+void CompactList<T, Allocator>::release() {
+  clear();
+  if (slots_ != nullptr) {
+    slot_allocator_traits::deallocate(slot_allocator_, slots_, capacity_);
+    slots_ = nullptr;
+    capacity_ = 0;
+    used_ = 0;
+  }
+}
+
+template <typename T, typename Allocator>
+CompactList<T, Allocator>::CompactList(size_t size, const T& value,
+                                       const Allocator& alloc)
+    : slot_allocator_(alloc) {
+  try {
+    reserve(size);
+    for (size_t i = 0; i < size; ++i) {
+      push_back(value);
+    }
+  } catch (...) {
+    release();
+    throw;
+  }
+}
+
+template <typename T, typename Allocator>
+CompactList<T, Allocator>::CompactList(size_t size, const T& value)
+    : CompactList(size, value, Allocator()) {
+}
+
+template <typename T, typename Allocator>
+CompactList<T, Allocator>::CompactList(const CompactList& other)
+    : slot_allocator_(
+          slot_allocator_traits::select_on_container_copy_construction(
+              other.slot_allocator_)) {
+  try {
+    reserve(other.size_);
+    for (const auto& x : other) {
+      push_back(x);
+    }
+  } catch (...) {
+    release();
+    throw;
+  }
+}
+
+template <typename T, typename Allocator>
+CompactList<T, Allocator>::CompactList(CompactList&& other) noexcept
+    : slot_allocator_(std::move(other.slot_allocator_)) {
+  steal(other);
+}
+
+template <typename T, typename Allocator>
+CompactList<T, Allocator>::~CompactList() {
+  release();
+}
+
+template <typename T, typename Allocator>
+CompactList<T, Allocator>& CompactList<T, Allocator>::operator=(
+    const CompactList& other) {
+  if (&other == this) {
+    return *this;
+  }
+  constexpr bool propagate =
+      slot_allocator_traits::propagate_on_container_copy_assignment::value;
+  CompactList tmp(propagate ? other.get_allocator() : get_allocator());
+  tmp.reserve(other.size_);
+  for (const auto& x : other) {
+    tmp.push_back(x);
+  }
+  release();
+  if constexpr (propagate) {
+    slot_allocator_ = other.slot_allocator_;
+  }
+  steal(tmp);
+  return *this;
+}
+
+template <typename T, typename Allocator>
+CompactList<T, Allocator>& CompactList<T, Allocator>::operator=(
+    CompactList&& other) noexcept(nothrow_move_assign) {
+  if (&other == this) {
+    return *this;
+  }
+  if (slot_allocator_traits::propagate_on_container_move_assignment::value ||
+      slot_allocator_ == other.slot_allocator_) {
+    release();
+    if constexpr (slot_allocator_traits::
+                      propagate_on_container_move_assignment::value) {
+      slot_allocator_ = std::move(other.slot_allocator_);
+    }
+    steal(other);
+    return *this;
+  }
+  CompactList tmp(get_allocator());
+  tmp.reserve(other.size_);
+  for (auto& x : other) {
+    tmp.push_back(std::move(x));
+  }
+  *this = std::move(tmp);
+  other.clear();
+  return *this;
+}
+
+template <typename T, typename Allocator>
+void CompactList<T, Allocator>::clear() {
+  if (slots_ == nullptr) {
+    return;
+  }
+  for (uint32_t i = slots_[sentinel].next; i != sentinel; i = slots_[i].next) {
+    slot_allocator_traits::destroy(slot_allocator_, slots_[i].value());
+  }
+  slots_[sentinel].next = sentinel;
+  slots_[sentinel].previous = sentinel;
+  used_ = 1;
+  free_head_ = sentinel;
+  size_ = 0;
+}
+
+template <typename T, typename Allocator>
+void CompactList<T, Allocator>::reserve(size_t count) {
+  if (count + 1 > capacity_) {
+    grow(count + 1);
+  }
+}
+
+template <typename T, typename Allocator>
+void CompactList<T, Allocator>::push_back(const T& value) {
+  emplace(end(), value);
+}
+
+template <typename T, typename Allocator>
+void CompactList<T, Allocator>::push_back(T&& value) {
+  emplace(end(), std::move(value));
+}
+
+template <typename T, typename Allocator>
+void CompactList<T, Allocator>::push_front(const T& value) {
+  emplace(begin(), value);
+}
+
+template <typename T, typename Allocator>
+void CompactList<T, Allocator>::push_front(T&& value) {
+  emplace(begin(), std::move(value));
+}
+
+template <typename T, typename Allocator>
+template <typename... Args>
+void CompactList<T, Allocator>::emplace_back(Args&&... args) {
+  emplace(end(), std::forward<Args>(args)...);
+}
+
+template <typename T, typename Allocator>
+template <typename... Args>
+void CompactList<T, Allocator>::emplace_front(Args&&... args) {
+  emplace(begin(), std::forward<Args>(args)...);
+}
+
+template <typename T, typename Allocator>
+void CompactList<T, Allocator>::pop_back() {
+  erase(--end());
+}
+
+template <typename T, typename Allocator>
+void CompactList<T, Allocator>::pop_front() {
+  erase(begin());
+}
+
+template <typename T, typename Allocator>
+void CompactList<T, Allocator>::insert(const_iterator iter, const T& value) {
+  emplace(iter, value);
+}
+
+template <typename T, typename Allocator>
+void CompactList<T, Allocator>::insert(const_iterator iter, T&& value) {
+  emplace(iter, std::move(value));
+}
+
+template <typename T, typename Allocator>
+void CompactList<T, Allocator>::erase(const_iterator iter) {
+  unlink(iter.index_);
+  slot_allocator_traits::destroy(slot_allocator_, slots_[iter.index_].value());
+  release_slot(iter.index_);
+  --size_;
+}
+
+template <typename T, typename Allocator>
+template <typename... Args>
+void CompactList<T, Allocator>::emplace(const_iterator iter, Args&&... args) {
+  uint32_t index = sentinel;
+  if (free_head_ == sentinel && used_ == capacity_) {
+    T value(std::forward<Args>(args)...);
+    index = acquire_slot();
+    try {
+      slot_allocator_traits::construct(slot_allocator_, slots_[index].value(),
+                                       std::move_if_noexcept(value));
+    } catch (...) {
+      release_slot(index);
+      throw;
+    }
+  } else {
+    index = acquire_slot();
+    try {
+      slot_allocator_traits::construct(slot_allocator_, slots_[index].value(),
+                                       std::forward<Args>(args)...);
+    } catch (...) {
+      release_slot(index);
+      throw;
+    }
+  }
+  link_before(iter.index_, index);
+  ++size_;
+}
@@ -0,0 +1,234 @@
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <memory_resource>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "compact_list.h"
+#include "stackallocator.h"
+
+#ifndef NO_TEST
+
+// NOLINTBEGIN
+
+constexpr size_t STORAGE_SIZE = 100'000'000;
+StackStorage<STORAGE_SIZE> STATIC_STORAGE;
+
+template <typename Alloc = std::allocator<std::string>>
+void CompareWithStdList(Alloc alloc = Alloc()) {
+    std::mt19937 gen(40);
+    CompactList<std::string, Alloc> lst(alloc);
+    std::list<std::string> expected;
+    for (int step = 0; step < 20'000; ++step) {
+        size_t position = expected.empty() ? 0 : gen() % (expected.size() + 1);
+        auto it = std::next(lst.cbegin(), position);
+        auto expected_it = std::next(expected.begin(), position);
+        unsigned action = gen() % 8;
+        if (action < 4 || expected.empty()) {
+            lst.insert(it, std::to_string(step));
+            expected.insert(expected_it, std::to_string(step));
+        } else if (action < 6) {
+            if (position == expected.size()) {
+                --it;
+                --expected_it;
+            }
+            lst.erase(it);
+            expected.erase(expected_it);
+        } else if (action == 6) {
+            lst.emplace_front(5, 'x');
+            expected.emplace_front(5, 'x');
+        } else {
+            lst.pop_back();
+            expected.pop_back();
+        }
+        assert(lst.size() == expected.size());
+        if (step % 1'000 == 0) {
+            assert(std::equal(lst.begin(), lst.end(), expected.begin(), expected.end()));
+            assert(std::equal(lst.rbegin(), lst.rend(), expected.rbegin(), expected.rend()));
+        }
+    }
+    assert(std::equal(lst.begin(), lst.end(), expected.begin(), expected.end()));
+
+    CompactList<std::string, Alloc> copy = lst;
+    assert(std::equal(copy.begin(), copy.end(), expected.begin(), expected.end()));
+    CompactList<std::string, Alloc> moved = std::move(copy);
+    assert(copy.size() == 0 && copy.begin() == copy.end());
+    copy = moved;
+    moved.clear();
+    assert(moved.empty() && moved.begin() == moved.end());
+    moved = std::move(copy);
+    assert(std::equal(moved.begin(), moved.end(), expected.begin(), expected.end()));
+}
+
+void TestIteratorsSurviveGrowth() {
+    CompactList<int> lst;
+    lst.push_back(0);
+    auto first = lst.begin();
+    for (int i = 1; i < 10'000; ++i) {
+        lst.push_back(i);
+    }
+    assert(*first == 0);
+    assert(lst.capacity() >= 10'000);
+
+    CompactList<std::string> strings;
+    strings.push_back("self reference survives reallocation");
+    for (int i = 0; i < 100; ++i) {
+        strings.push_back(*strings.begin());
+    }
+    assert(std::all_of(strings.begin(), strings.end(), [](const std::string& s) {
+        return s == "self reference survives reallocation";
+    }));
+}
+
+void TestSlotReuse() {
+    CompactList<int> lst;
+    lst.reserve(100);
+    const size_t memory = lst.memory_usage();
+    for (int round = 0; round < 1'000; ++round) {
+        for (int i = 0; i < 100; ++i) {
+            lst.push_back(i);
+        }
+        while (!lst.empty()) {
+            lst.pop_front();
+        }
+    }
+    assert(lst.memory_usage() == memory);
+}
+
+void TestCopyAssignment() {
+    StackStorage<1 << 20> first;
+    StackStorage<1 << 20> second;
+    using Alloc = StackAllocator<int, 1 << 20>;
+    CompactList<int, Alloc> a{Alloc(first)};
+    CompactList<int, Alloc> b{Alloc(second)};
+    for (int i = 0; i < 100; ++i) {
+        a.push_back(i);
+    }
+    b.push_back(-1);
+    size_t used = first.used();
+
+    // StackAllocator does not propagate: the copy lives in b's own storage
+    b = a;
+    assert(first.used() == used && second.used() > 0);
+    assert(b.get_allocator() == Alloc(second));
+    assert(std::equal(a.begin(), a.end(), b.begin(), b.end()));
+    b.push_back(100);
+    assert(b.size() == 101 && first.used() == used);
+
+    std::pmr::monotonic_buffer_resource left;
+    std::pmr::monotonic_buffer_resource right;
+    using Pmr = std::pmr::polymorphic_allocator<std::pmr::string>;
+    CompactList<std::pmr::string, Pmr> x{Pmr(&left)};
+    CompactList<std::pmr::string, Pmr> y{Pmr(&right)};
+    for (int i = 0; i < 20; ++i) {
+        x.push_back(std::pmr::string(40, 'a' + i));
+    }
+    y = x;
+    assert(y.get_allocator().resource() == &right);
+    assert(std::equal(x.begin(), x.end(), y.begin(), y.end()));
+}
+
+template <typename Container>
+long long Churn(Container& lst, int steps) {
+    std::mt19937 gen(7);
+    long long checksum = 0;
+    for (int i = 0; i < 1'000'000; ++i) {
+        lst.push_back(i);
+    }
+    auto it = lst.begin();
+    for (int i = 0; i < steps; ++i) {
+        if (it == lst.end()) {
+            it = lst.begin();
+        }
+        if (gen() % 2 == 0) {
+            lst.insert(it, i);
+        } else {
+            auto next = std::next(it);
+            lst.erase(it);
+            it = next;
+        }
+        if (it != lst.end()) {
+            ++it;
+        }
+    }
+    for (int round = 0; round < 10; ++round) {
+        for (long long x : lst) {
+            checksum += x;
+        }
+    }
+    return checksum;
+}
+
+void CompareWithList() {
+    using namespace std::chrono;
+
+    StackStorage<STORAGE_SIZE>& storage = STATIC_STORAGE;
+    const size_t used = storage.used();
+    {
+        List<int64_t, StackAllocator<int64_t, STORAGE_SIZE>> lst(storage);
+        for (int i = 0; i < 100'000; ++i) {
+            lst.push_back(i);
+        }
+        CompactList<int64_t> compact;
+        compact.reserve(100'000);
+        for (int i = 0; i < 100'000; ++i) {
+            compact.push_back(i);
+        }
+        double list_bytes = static_cast<double>(storage.used() - used) / 100'000;
+        double compact_bytes = static_cast<double>(compact.memory_usage()) / 100'000;
+        assert(compact_bytes * 1.4 < list_bytes);
+        std::cerr << " bytes per int64_t element: List " << list_bytes
+                  << " (plus malloc headers with std::allocator), CompactList " << compact_bytes << std::endl;
+    }
+
+    auto start = high_resolution_clock::now();
+    List<int64_t> lst;
+    long long list_sum = Churn(lst, 2'000'000);
+    auto list_done = high_resolution_clock::now();
+    CompactList<int64_t> compact;
+    long long compact_sum = Churn(compact, 2'000'000);
+    auto compact_done = high_resolution_clock::now();
+    assert(list_sum == compact_sum);
+    std::cerr << " churn + 10 traversals: List " << duration_cast<milliseconds>(list_done - start).count()
+              << " ms, CompactList " << duration_cast<milliseconds>(compact_done - list_done).count() << " ms"
+              << std::endl;
+}
+
+int main() {
+    CompareWithStdList();
+    std::cerr << "Test 1 (random operations against std::list) passed." << std::endl;
+
+    CompareWithStdList(StackAllocator<std::string, STORAGE_SIZE>(STATIC_STORAGE));
+    std::cerr << "Test 2 (CompactList with StackAllocator) passed." << std::endl;
+
+    TestIteratorsSurviveGrowth();
+    std::cerr << "Test 3 (iterators survive pool growth) passed." << std::endl;
+
+    TestSlotReuse();
+    std::cerr << "Test 4 (free slots are reused) passed." << std::endl;
+
+    TestCopyAssignment();
+    std::cerr << "Test 5 (copy assignment between allocators) passed." << std::endl;
+
+    CompareWithList();
+    std::cerr << "Test 6 (memory and speed against List) passed." << std::endl;
+
+    std::cout << 0;
+}
+
+// NOLINTEND
+
+#else
+
+int main() {
+    std::cerr << "Tests are turned off!\n";
+}
+
+#endif
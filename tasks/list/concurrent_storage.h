@@ -0,0 +1,188 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#include "arena_allocator.h"
+#include "stackstorage.h"
+
+template <size_t N>
+class ConcurrentStackStorage {
+ private:
+  alignas(std::max_align_t) char data_[N];
+  std::atomic<size_t> shift_ = 0;
+
+ public:
+  using partial_deallocation = std::true_type;
+
+  ConcurrentStackStorage() = default;
+  ConcurrentStackStorage(const ConcurrentStackStorage&) = delete;
+  ConcurrentStackStorage& operator=(const ConcurrentStackStorage&) = delete;
+
+  template <typename T>
+  T* allocate(size_t n);
+
+  template <typename T>
+  void deallocate(T*, size_t) {
+  }
+
+  size_t used() const {
+    return std::min(shift_.load(std::memory_order_relaxed), N);
+  }
+};
+
+template <size_t N>
+template <typename T>
+T* ConcurrentStackStorage<N>::allocate(size_t n) {
+  size_t bytes = n * sizeof(T) + alignof(T) - 1;
+  size_t offset = shift_.fetch_add(bytes, std::memory_order_relaxed);
+  if (offset > N || N - offset < bytes) {
+    throw std::bad_alloc();
+  }
+  void* result = data_ + offset;
+  std::align(alignof(T), n * sizeof(T), result, bytes);
+  return static_cast<T*>(result);
+}
+
+// One arena per thread and registry. A block goes back to its arena only
+// when the freeing thread owns that arena; frees from other threads are left
+// for the arena to reclaim when the registry goes away.
+template <typename Arena>
+class ThreadLocalArenas {
+ private:
+  // ids tell a live registry from a dead one that left an entry behind at
+  // the same address
+  struct CacheEntry {
+    size_t registry;
+    ThreadLocalArenas* owner;
+    Arena* arena;
+  };
+
+  static std::vector<CacheEntry>& cache() {
+    thread_local std::vector<CacheEntry> entries;
+    return entries;
+  }
+
+  // guards live_registries()
+  static std::mutex& registry_mutex() {
+    static std::mutex mutex;
+    return mutex;
+  }
+
+  static std::vector<ThreadLocalArenas*>& live_registries() {
+    static std::vector<ThreadLocalArenas*> registries;
+    return registries;
+  }
+
+  static bool is_live(const CacheEntry& entry);
+
+  static size_t next_id() {
+    static std::atomic<size_t> counter = 0;
+    return ++counter;
+  }
+
+  size_t id_ = next_id();
+  mutable std::mutex mutex_;
+  std::vector<std::unique_ptr<Arena>> arenas_;
+
+  Arena* find_local() const;
+  Arena& register_thread();
+
+ public:
+  using partial_deallocation = allows_partial_deallocation<Arena>;
+
+  ThreadLocalArenas();
+  ThreadLocalArenas(const ThreadLocalArenas&) = delete;
+  ThreadLocalArenas& operator=(const ThreadLocalArenas&) = delete;
+  ~ThreadLocalArenas();
+
+  Arena& local();
+
+  template <typename T>
+  T* allocate(size_t n) {
+    return local().template allocate<T>(n);
+  }
+
+  template <typename T>
+  void deallocate(T* ptr, size_t n) {
+    Arena* arena = find_local();
+    if (arena != nullptr && arena->owns(ptr)) {
+      arena->deallocate(ptr, n);
+    }
+  }
+
+  size_t size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return arenas_.size();
+  }
+};
+
+template <typename Arena>
+ThreadLocalArenas<Arena>::ThreadLocalArenas() {
+  std::lock_guard<std::mutex> lock(registry_mutex());
+  live_registries().push_back(this);
+}
+
+template <typename Arena>
+ThreadLocalArenas<Arena>::~ThreadLocalArenas() {
+  std::lock_guard<std::mutex> lock(registry_mutex());
+  std::vector<ThreadLocalArenas*>& registries = live_registries();
+  registries.erase(std::find(registries.begin(), registries.end(), this));
+}
+
+template <typename Arena>
+bool ThreadLocalArenas<Arena>::is_live(const CacheEntry& entry) {
+  const std::vector<ThreadLocalArenas*>& registries = live_registries();
+  return std::find(registries.begin(), registries.end(), entry.owner) !=
+             registries.end() &&
+         entry.owner->id_ == entry.registry;
+}
+
+template <typename Arena>
+Arena* ThreadLocalArenas<Arena>::find_local() const {
+  for (const CacheEntry& entry : cache()) {
+    if (entry.registry == id_) {
+      return entry.arena;
+    }
+  }
+  return nullptr;
+}
+
+template <typename Arena>
+Arena& ThreadLocalArenas<Arena>::local() {
+  Arena* arena = find_local();
+  return arena != nullptr ? *arena : register_thread();
+}
+
+template <typename Arena>
+Arena& ThreadLocalArenas<Arena>::register_thread() {
+  std::unique_ptr<Arena> arena(new Arena);
+  Arena* result = arena.get();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    arenas_.push_back(std::move(arena));
+  }
+  std::vector<CacheEntry>& entries = cache();
+  {
+    std::lock_guard<std::mutex> lock(registry_mutex());
+    // drop the entries of registries destroyed since this thread last
+    // registered
+    std::erase_if(entries,
+                  [](const CacheEntry& entry) { return !is_live(entry); });
+  }
+  entries.push_back({id_, this, result});
+  return *result;
+}
+
+template <typename T, size_t N>
+using ConcurrentStackAllocator = ArenaAllocator<T, ConcurrentStackStorage<N>>;
+
+template <typename T, size_t N>
+using ThreadLocalStackAllocator =
+    ArenaAllocator<T, ThreadLocalArenas<StackStorage<N>>>;
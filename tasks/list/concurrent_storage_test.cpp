@@ -0,0 +1,153 @@
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "concurrent_storage.h"
+#include "stackallocator.h"
+
+#ifndef NO_TEST
+
+// NOLINTBEGIN
+
+constexpr size_t THREADS = 4;
+constexpr size_t NODES_PER_THREAD = 250'000;
+constexpr size_t SHARED_SIZE = 64'000'000;
+constexpr size_t LOCAL_SIZE = 16'000'000;
+
+ConcurrentStackStorage<SHARED_SIZE> SHARED_STORAGE;
+
+template <typename Function>
+void RunThreads(Function function) {
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < THREADS; ++i) {
+        threads.emplace_back(function, i);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void TestNoOverlap() {
+    static ConcurrentStackStorage<1'000'000> storage;
+    std::vector<std::vector<long long*>> blocks(THREADS);
+
+    RunThreads([&](size_t id) {
+        ConcurrentStackAllocator<char, 1'000'000> charalloc(storage);
+        ConcurrentStackAllocator<long long, 1'000'000> alloc(charalloc);
+        for (int i = 0; i < 5'000; ++i) {
+            charalloc.allocate(1 + i % 3);
+            long long* block = alloc.allocate(2);
+            assert(reinterpret_cast<uintptr_t>(block) % alignof(long long) == 0);
+            block[0] = block[1] = id;
+            blocks[id].push_back(block);
+        }
+    });
+
+    std::set<long long*> all;
+    for (size_t id = 0; id < THREADS; ++id) {
+        for (long long* block : blocks[id]) {
+            assert(block[0] == (long long)id && block[1] == (long long)id);
+            all.insert(block);
+        }
+    }
+    assert(all.size() == THREADS * 5'000);
+
+    try {
+        ConcurrentStackAllocator<char, 1'000'000>(storage).allocate(1'000'000);
+        assert(false);
+    } catch (std::bad_alloc&) {}
+}
+
+void TestThreadLocalRegistry() {
+    ThreadLocalArenas<StackStorage<1'000>> registry;
+    std::vector<void*> arenas(THREADS);
+
+    RunThreads([&](size_t id) {
+        arenas[id] = &registry.local();
+        assert(&registry.local() == arenas[id]);
+        ThreadLocalStackAllocator<int, 1'000> alloc(registry);
+        int* p = alloc.allocate(10);
+        assert(registry.local().used() >= 10 * sizeof(int));
+        alloc.deallocate(p, 10);
+        assert(registry.local().used() == 0);
+    });
+
+    assert(registry.size() == THREADS);
+    assert(std::set<void*>(arenas.begin(), arenas.end()).size() == THREADS);
+
+    ThreadLocalArenas<StackStorage<1'000>> another;
+    assert(&another.local() != &registry.local());
+    assert(registry.size() == THREADS + 1);
+
+    // a thread that only frees does not get an arena, and leaves the block
+    // to the arena that owns it
+    ThreadLocalStackAllocator<int, 1'000> alloc(registry);
+    int* p = alloc.allocate(10);
+    size_t used = registry.local().used();
+    std::thread([&] { alloc.deallocate(p, 10); }).join();
+    assert(registry.size() == THREADS + 1);
+    assert(registry.local().used() == used);
+    alloc.deallocate(p, 10);
+    assert(registry.local().used() < used);
+
+    // registries that come and go do not break the lookups of live ones
+    for (int i = 0; i < 100; ++i) {
+        ThreadLocalArenas<StackStorage<1'000>> temporary;
+        ThreadLocalStackAllocator<int, 1'000>(temporary).allocate(1);
+    }
+    assert(&registry.local() == &registry.local() && registry.size() == THREADS + 1);
+}
+
+template <typename Alloc>
+long long BuildLists(Alloc alloc) {
+    using namespace std::chrono;
+    auto start = high_resolution_clock::now();
+    RunThreads([&](size_t id) {
+        List<int, Alloc> lst(alloc);
+        for (size_t i = 0; i < NODES_PER_THREAD; ++i) {
+            lst.push_back(i + id);
+        }
+        assert(lst.size() == NODES_PER_THREAD);
+    });
+    return duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+}
+
+void TestPerformance() {
+    ThreadLocalArenas<StackStorage<LOCAL_SIZE>> registry;
+
+    long long malloc_time = BuildLists(std::allocator<int>());
+    long long shared_time = BuildLists(ConcurrentStackAllocator<int, SHARED_SIZE>(SHARED_STORAGE));
+    long long local_time = BuildLists(ThreadLocalStackAllocator<int, LOCAL_SIZE>(registry));
+
+    std::cerr << " " << THREADS << " threads x " << NODES_PER_THREAD
+              << " List nodes: malloc " << malloc_time << " ms, ConcurrentStackStorage "
+              << shared_time << " ms, thread-local StackStorage " << local_time << " ms"
+              << std::endl;
+}
+
+int main() {
+    TestNoOverlap();
+    std::cerr << "Test 1 (concurrent bump allocation) passed." << std::endl;
+
+    TestThreadLocalRegistry();
+    std::cerr << "Test 2 (thread-local registry) passed." << std::endl;
+
+    TestPerformance();
+    std::cerr << "Test 3 (performance) passed." << std::endl;
+
+    std::cout << 0;
+}
+
+// NOLINTEND
+
+#else
+
+int main() {
+    std::cerr << "Tests are turned off!\n";
+}
+
+#endif
@@ -0,0 +1,341 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+template <typename T, typename Allocator = std::allocator<T>>
+class ForwardList {
+ private:
+  struct BaseNode {
+    BaseNode* next = nullptr;
+  };
+  struct Node : public BaseNode {
+    T value;
+    template <typename... Args>
+    Node(Args&&... args)
+        : value(std::forward<Args>(args)...) {
+    }
+  };
+  using NodeAllocator =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+  using node_allocator_traits = typename std::allocator_traits<NodeAllocator>;
+
+  static constexpr bool nothrow_move_assign =
+      node_allocator_traits::propagate_on_container_move_assignment::value ||
+      node_allocator_traits::is_always_equal::value;
+
+  [[no_unique_address]] NodeAllocator node_allocator_;
+  BaseNode head_;
+  BaseNode* tail_ = &head_;
+  size_t size_ = 0;
+
+  template <typename... Args>
+  BaseNode* link_after(BaseNode* position, Args&&... args);
+  void steal(ForwardList& other);
+
+  template <bool is_constant>
+  class base_iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::conditional_t<is_constant, const T, T>;
+    using pointer = std::conditional_t<is_constant, const T*, T*>;
+    using reference = std::conditional_t<is_constant, const T&, T&>;
+    using difference_type = int;
+
+   private:
+    BaseNode* node_;
+
+   public:
+    base_iterator()
+        : node_(nullptr) {
+    }
+    base_iterator(const BaseNode* node)
+        : node_(const_cast<BaseNode*>(node)) {
+    }
+
+    base_iterator& operator++() {
+      node_ = node_->next;
+      return *this;
+    }
+    base_iterator operator++(int) {
+      base_iterator result = *this;
+      ++(*this);
+      return result;
+    }
+
+    bool operator==(const base_iterator& other) const {
+      return node_ == other.node_;
+    }
+    bool operator!=(const base_iterator& other) const {
+      return node_ != other.node_;
+    }
+
+    operator base_iterator<true>() const {
+      return base_iterator<true>(node_);
+    }
+
+    pointer operator->() const {
+      return &(static_cast<Node*>(node_)->value);
+    }
+
+    reference operator*() const {
+      return static_cast<Node*>(node_)->value;
+    }
+
+    friend class ForwardList<T, Allocator>;
+  };
+
+ public:
+  using iterator = base_iterator<false>;
+  using const_iterator = base_iterator<true>;
+
+  ForwardList(const Allocator& alloc)
+      : node_allocator_(alloc) {
+  }
+  ForwardList()
+      : node_allocator_() {
+  }
+  ForwardList(size_t size, const T& value, const Allocator& alloc);
+  ForwardList(size_t size, const T& value)
+      : ForwardList(size, value, Allocator()) {
+  }
+  ForwardList(const ForwardList& other);
+  ForwardList(ForwardList&& other) noexcept;
+  ForwardList& operator=(const ForwardList& other);
+  ForwardList& operator=(ForwardList&& other) noexcept(nothrow_move_assign);
+  ~ForwardList() {
+    clear();
+  }
+
+  void clear();
+
+  size_t size() const {
+    return size_;
+  }
+  bool empty() const {
+    return size_ == 0;
+  }
+
+  Allocator get_allocator() const {
+    return Allocator(node_allocator_);
+  }
+
+  T& front() {
+    return static_cast<Node*>(head_.next)->value;
+  }
+  const T& front() const {
+    return static_cast<const Node*>(head_.next)->value;
+  }
+  T& back() {
+    return static_cast<Node*>(tail_)->value;
+  }
+  const T& back() const {
+    return static_cast<const Node*>(tail_)->value;
+  }
+
+  void push_front(const T& value) {
+    link_after(&head_, value);
+  }
+  void push_front(T&& value) {
+    link_after(&head_, std::move(value));
+  }
+  void push_back(const T& value) {
+    link_after(tail_, value);
+  }
+  void push_back(T&& value) {
+    link_after(tail_, std::move(value));
+  }
+  template <typename... Args>
+  void emplace_front(Args&&... args) {
+    link_after(&head_, std::forward<Args>(args)...);
+  }
+  template <typename... Args>
+  void emplace_back(Args&&... args) {
+    link_after(tail_, std::forward<Args>(args)...);
+  }
+  void pop_front() {
+    erase_after(cbefore_begin());
+  }
+
+  iterator insert_after(const_iterator position, const T& value) {
+    return iterator(link_after(position.node_, value));
+  }
+  iterator insert_after(const_iterator position, T&& value) {
+    return iterator(link_after(position.node_, std::move(value)));
+  }
+  template <typename... Args>
+  iterator emplace_after(const_iterator position, Args&&... args) {
+    return iterator(link_after(position.node_, std::forward<Args>(args)...));
+  }
+  iterator erase_after(const_iterator position);
+
+  iterator before_begin() {
+    return iterator(&head_);
+  }
+  const_iterator before_begin() const {
+    return const_iterator(&head_);
+  }
+  const_iterator cbefore_begin() const {
+    return before_begin();
+  }
+  iterator begin() {
+    return iterator(head_.next);
+  }
+  const_iterator begin() const {
+    return const_iterator(head_.next);
+  }
+  const_iterator cbegin() const {
+    return begin();
+  }
+  iterator end() {
+    return iterator(nullptr);
+  }
+  const_iterator end() const {
+    return const_iterator(nullptr);
+  }
+  const_iterator cend() const {
+    return end();
+  }
+};
+
+template <typename T, typename Allocator>
+template <typename... Args>
+typename ForwardList<T, Allocator>::BaseNode*
+ForwardList<T, Allocator>::link_after(BaseNode* position, Args&&... args) {
+  Node* node = node_allocator_traits::allocate(node_allocator_, 1);
+  try {
+    node_allocator_traits::construct(node_allocator_, node,
+                                     std::forward<Args>(args)...);
+  } catch (...) {
+    node_allocator_traits::deallocate(node_allocator_, node, 1);
+    throw;
+  }
+  node->next = position->next;
+  position->next = node;
+  if (position == tail_) {
+    tail_ = node;
+  }
+  ++size_;
+  return node;
+}
+
+template <typename T, typename Allocator>
+typename ForwardList<T, Allocator>::iterator
+ForwardList<T, Allocator>::erase_after(const_iterator position) {
+  BaseNode* previous = position.node_;
+  Node* node = static_cast<Node*>(previous->next);
+  previous->next = node->next;
+  if (tail_ == node) {
+    tail_ = previous;
+  }
+  node_allocator_traits::destroy(node_allocator_, node);
+  node_allocator_traits::deallocate(node_allocator_, node, 1);
+  --size_;
+  return iterator(previous->next);
+}
+
+template <typename T, typename Allocator>
+void ForwardList<T, Allocator>::steal(ForwardList& other) {
+  head_.next = std::exchange(other.head_.next, nullptr);
+  tail_ = other.tail_ == &other.head_ ? &head_ : other.tail_;
+  other.tail_ = &other.head_;
+  size_ = std::exchange(other.size_, 0);
+}
+
+template <typename T, typename Allocator>
+void ForwardList<T, Allocator>::clear() {
+  BaseNode* node = head_.next;
+  while (node != nullptr) {
+    Node* current = static_cast<Node*>(node);
+    node = node->next;
+    node_allocator_traits::destroy(node_allocator_, current);
+    node_allocator_traits::deallocate(node_allocator_, current, 1);
+  }
+  head_.next = nullptr;
+  tail_ = &head_;
+  size_ = 0;
+}
+
+template <typename T, typename Allocator>
+ForwardList<T, Allocator>::ForwardList(size_t size, const T& value,
+                                       const Allocator& alloc)
+    : node_allocator_(alloc) {
+  try {
+    for (size_t i = 0; i < size; ++i) {
+      push_back(value);
+    }
+  } catch (...) {
+    clear();
+    throw;
+  }
+}
+
+template <typename T, typename Allocator>
+ForwardList<T, Allocator>::ForwardList(const ForwardList& other)
+    : node_allocator_(
+          node_allocator_traits::select_on_container_copy_construction(
+              other.node_allocator_)) {
+  try {
+    for (const T& value : other) {
+      push_back(value);
+    }
+  } catch (...) {
+    clear();
+    throw;
+  }
+}
+
+template <typename T, typename Allocator>
+ForwardList<T, Allocator>::ForwardList(ForwardList&& other) noexcept
+    : node_allocator_(std::move(other.node_allocator_)) {
+  steal(other);
+}
+
+template <typename T, typename Allocator>
+ForwardList<T, Allocator>& ForwardList<T, Allocator>::operator=(
+    const ForwardList& other) {
+  if (&other == this) {
+    return *this;
+  }
+  constexpr bool propagate =
+      node_allocator_traits::propagate_on_container_copy_assignment::value;
+  ForwardList tmp(propagate ? other.get_allocator() : get_allocator());
+  for (const T& value : other) {
+    tmp.push_back(value);
+  }
+  clear();
+  if constexpr (propagate) {
+    node_allocator_ = other.node_allocator_;
+  }
+  steal(tmp);
+  return *this;
+}
+
+template <typename T, typename Allocator>
+ForwardList<T, Allocator>& ForwardList<T, Allocator>::operator=(
+    ForwardList&& other) noexcept(nothrow_move_assign) {
+  if (&other == this) {
+    return *this;
+  }
+  if (node_allocator_traits::propagate_on_container_move_assignment::value ||
+      node_allocator_ == other.node_allocator_) {
+    clear();
+    if constexpr (node_allocator_traits::
+                      propagate_on_container_move_assignment::value) {
+      node_allocator_ = std::move(other.node_allocator_);
+    }
+    steal(other);
+    return *this;
+  }
+  ForwardList tmp(get_allocator());
+  for (T& value : other) {
+    tmp.push_back(std::move(value));
+  }
+  clear();
+  steal(tmp);
+  other.clear();
+  return *this;
+}
@@ -0,0 +1,162 @@
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "forward_list.h"
+#include "stackallocator.h"
+
+#ifndef NO_TEST
+
+// NOLINTBEGIN
+
+constexpr size_t STORAGE_SIZE = 10'000'000;
+StackStorage<STORAGE_SIZE> STATIC_STORAGE;
+
+template <typename List>
+std::vector<int> Values(const List& lst) {
+    return std::vector<int>(lst.begin(), lst.end());
+}
+
+void TestBasic() {
+    ForwardList<int> lst;
+    assert(lst.empty() && lst.begin() == lst.end());
+    lst.push_back(2);
+    lst.push_front(1);
+    lst.push_back(4);
+    auto it = lst.insert_after(std::next(lst.begin()), 3);
+    assert(*it == 3 && lst.back() == 4 && lst.front() == 1);
+    assert((Values(lst) == std::vector<int>{1, 2, 3, 4}));
+
+    // erasing the last node moves the tail back
+    auto after = lst.erase_after(it);
+    assert(after == lst.end() && lst.back() == 3);
+    lst.push_back(5);
+    lst.emplace_after(lst.before_begin(), 0);
+    lst.emplace_back(6);
+    assert((Values(lst) == std::vector<int>{0, 1, 2, 3, 5, 6}));
+    assert(std::distance(lst.begin(), lst.end()) == 6 && lst.size() == 6);
+    assert(*std::find(lst.begin(), lst.end(), 5) == 5);
+
+    while (!lst.empty()) {
+        lst.pop_front();
+    }
+    lst.push_back(7);
+    assert(lst.front() == 7 && lst.back() == 7 && lst.size() == 1);
+
+    ForwardList<std::unique_ptr<std::string>> owners;
+    owners.push_back(std::make_unique<std::string>("b"));
+    owners.emplace_front(new std::string("a"));
+    ForwardList<std::unique_ptr<std::string>> moved = std::move(owners);
+    assert(owners.empty() && *moved.front() == "a" && *moved.back() == "b");
+    moved.push_back(std::make_unique<std::string>("c"));
+    owners = std::move(moved);
+    assert(owners.size() == 3 && *owners.back() == "c");
+
+    ForwardList<int> copy(3, 9);
+    ForwardList<int> other = copy;
+    other.push_back(10);
+    copy = other;
+    assert((Values(copy) == std::vector<int>{9, 9, 9, 10}) && copy.back() == 10);
+    copy.push_back(11);
+    assert(copy.size() == 5 && other.size() == 4);
+}
+
+void TestAllocator() {
+    using Alloc = StackAllocator<long long, STORAGE_SIZE>;
+    const size_t count = 10'000;
+
+    size_t doubly = 0;
+    size_t singly = 0;
+    {
+        size_t start = STATIC_STORAGE.used();
+        List<long long, Alloc> lst{Alloc(STATIC_STORAGE)};
+        for (size_t i = 0; i < count; ++i) {
+            lst.push_back(i);
+        }
+        doubly = STATIC_STORAGE.used() - start;
+    }
+    {
+        size_t start = STATIC_STORAGE.used();
+        ForwardList<long long, Alloc> lst{Alloc(STATIC_STORAGE)};
+        for (size_t i = 0; i < count; ++i) {
+            lst.push_back(i);
+        }
+        singly = STATIC_STORAGE.used() - start;
+        assert(lst.back() == static_cast<long long>(count - 1));
+    }
+    assert(singly < doubly);
+
+    std::cerr << "  bytes per long long: List " << doubly / count << ", ForwardList " << singly / count
+              << std::endl;
+}
+
+template <typename Queue>
+long long Churn(Queue& queue, int backlog, int operations) {
+    long long sum = 0;
+    for (int i = 0; i < backlog; ++i) {
+        queue.push_back(i);
+    }
+    for (int i = 0; i < operations; ++i) {
+        sum += *queue.begin();
+        queue.pop_front();
+        queue.push_back(i);
+    }
+    for (int x : queue) {
+        sum += x;
+    }
+    return sum;
+}
+
+void CompareWithList() {
+    using namespace std::chrono;
+
+    const int backlog = 1'000'000;
+    const int operations = 5'000'000;
+
+    auto start = high_resolution_clock::now();
+    long long forward_sum = 0;
+    {
+        ForwardList<int> queue;
+        forward_sum = Churn(queue, backlog, operations);
+    }
+    auto forward_done = high_resolution_clock::now();
+    long long list_sum = 0;
+    {
+        List<int> queue;
+        list_sum = Churn(queue, backlog, operations);
+    }
+    auto list_done = high_resolution_clock::now();
+    assert(forward_sum == list_sum);
+
+    std::cerr << "  FIFO churn over " << backlog << " elements, " << operations << " ops: ForwardList "
+              << duration_cast<milliseconds>(forward_done - start).count() << " ms, List "
+              << duration_cast<milliseconds>(list_done - forward_done).count() << " ms" << std::endl;
+}
+
+int main() {
+    TestBasic();
+    std::cerr << "Test 1 (insert_after, erase_after and the tail) passed." << std::endl;
+
+    TestAllocator();
+    std::cerr << "Test 2 (memory per element with StackAllocator) passed." << std::endl;
+
+    CompareWithList();
+    std::cerr << "Test 3 (throughput against List) passed." << std::endl;
+
+    std::cout << 0;
+}
+
+// NOLINTEND
+
+#else
+
+int main() {
+    std::cerr << "Tests are turned off!\n";
+}
+
+#endif
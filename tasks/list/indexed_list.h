@@ -0,0 +1,567 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+// Doubly linked list with skip levels on top of the node chain. Every link
+// stores how many nodes it jumps over, which gives nth() and rank() in
+// expected O(log n); lower_bound() needs the list to be kept sorted.
+template <typename T, typename Compare = std::less<T>,
+          typename Allocator = std::allocator<T>>
+class IndexedList {
+ private:
+  struct BaseNode;
+  struct Link {
+    BaseNode* next;
+    BaseNode* previous;
+    size_t width;
+  };
+  struct BaseNode {
+    Link* links;
+    size_t height;
+  };
+  struct Node : public BaseNode {
+    T value;
+    template <typename... Args>
+    Node(Args&&... args)
+        : value(std::forward<Args>(args)...) {
+    }
+  };
+  using NodeAllocator =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+  using node_allocator_traits = typename std::allocator_traits<NodeAllocator>;
+  using LinkAllocator =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<Link>;
+  using link_allocator_traits = typename std::allocator_traits<LinkAllocator>;
+
+  static const size_t max_height = 32;
+  static constexpr bool nothrow_move_assign =
+      node_allocator_traits::propagate_on_container_move_assignment::value ||
+      node_allocator_traits::is_always_equal::value;
+
+  [[no_unique_address]] NodeAllocator node_allocator_;
+  [[no_unique_address]] LinkAllocator link_allocator_;
+  [[no_unique_address]] Compare compare_;
+  Link end_links_[max_height];
+  BaseNode end_;
+  size_t size_ = 0;
+  size_t levels_ = 1;
+  uint64_t seed_ = 0x9e3779b97f4a7c15ULL;
+
+  size_t random_height();
+  void reset();
+  void steal(IndexedList& other);
+
+  template <typename... Args>
+  BaseNode* make_node(Args&&... args);
+  void free_node(BaseNode* node);
+
+  void link_before(BaseNode* position, BaseNode* node);
+  void unlink(BaseNode* node);
+
+  static const T& value_of(const BaseNode* node) {
+    return static_cast<const Node*>(node)->value;
+  }
+
+  template <bool is_constant>
+  class base_iterator {
+   public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = std::conditional_t<is_constant, const T, T>;
+    using pointer = std::conditional_t<is_constant, const T*, T*>;
+    using reference = std::conditional_t<is_constant, const T&, T&>;
+    using difference_type = int;
+
+   private:
+    BaseNode* node_;
+
+   public:
+    base_iterator() = delete;
+    base_iterator(const BaseNode* node)
+        : node_(const_cast<BaseNode*>(node)) {
+    }
+
+    base_iterator& operator++() {
+      node_ = node_->links[0].next;
+      return *this;
+    }
+    base_iterator operator++(int) {
+      base_iterator result = *this;
+      ++(*this);
+      return result;
+    }
+
+    base_iterator& operator--() {
+      node_ = node_->links[0].previous;
+      return *this;
+    }
+    base_iterator operator--(int) {
+      base_iterator result = *this;
+      --(*this);
+      return result;
+    }
+
+    bool operator==(const base_iterator& other) const {
+      return node_ == other.node_;
+    }
+    bool operator!=(const base_iterator& other) const {
+      return node_ != other.node_;
+    }
+
+    operator base_iterator<true>() const {
+      return base_iterator<true>(node_);
+    }
+
+    pointer operator->() const {
+      return &(static_cast<Node*>(node_)->value);
+    }
+
+    reference operator*() const {
+      return static_cast<Node*>(node_)->value;
+    }
+
+    friend class IndexedList<T, Compare, Allocator>;
+  };
+
+ public:
+  using iterator = base_iterator<false>;
+  using const_iterator = base_iterator<true>;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  IndexedList(const Compare& compare, const Allocator& alloc);
+  IndexedList(const Allocator& alloc)
+      : IndexedList(Compare(), alloc) {
+  }
+  IndexedList()
+      : IndexedList(Compare(), Allocator()) {
+  }
+  IndexedList(const IndexedList& other);
+  IndexedList(IndexedList&& other) noexcept;
+  IndexedList& operator=(const IndexedList& other);
+  IndexedList& operator=(IndexedList&& other) noexcept(nothrow_move_assign);
+  ~IndexedList() {
+    clear();
+  }
+
+  void clear();
+
+  size_t size() const {
+    return size_;
+  }
+  bool empty() const {
+    return size_ == 0;
+  }
+
+  Allocator get_allocator() const {
+    return Allocator(node_allocator_);
+  }
+
+  void push_back(const T& value) {
+    emplace(cend(), value);
+  }
+  void push_front(const T& value) {
+    emplace(cbegin(), value);
+  }
+  void pop_back() {
+    erase(const_iterator(end_.links[0].previous));
+  }
+  void pop_front() {
+    erase(cbegin());
+  }
+
+  template <typename... Args>
+  iterator emplace(const_iterator position, Args&&... args);
+  iterator insert(const_iterator position, const T& value) {
+    return emplace(position, value);
+  }
+  iterator insert_after(const_iterator position, const T& value) {
+    return emplace(std::next(position), value);
+  }
+  // keeps the list sorted; equal elements stay in insertion order
+  iterator insert(const T& value) {
+    return emplace(upper_bound(value), value);
+  }
+  iterator erase(const_iterator position);
+
+  iterator nth(size_t index);
+  const_iterator nth(size_t index) const;
+  size_t rank(const_iterator position) const;
+
+  iterator lower_bound(const T& key);
+  const_iterator lower_bound(const T& key) const;
+  iterator upper_bound(const T& key);
+  const_iterator upper_bound(const T& key) const;
+
+  iterator begin() {
+    return iterator(end_.links[0].next);
+  }
+  const_iterator begin() const {
+    return const_iterator(end_.links[0].next);
+  }
+  const_iterator cbegin() const {
+    return begin();
+  }
+  iterator end() {
+    return iterator(&end_);
+  }
+  const_iterator end() const {
+    return const_iterator(&end_);
+  }
+  const_iterator cend() const {
+    return end();
+  }
+
+  reverse_iterator rbegin() {
+    return reverse_iterator(end());
+  }
+  const_reverse_iterator rbegin() const {
+    return const_reverse_iterator(end());
+  }
+  reverse_iterator rend() {
+    return reverse_iterator(begin());
+  }
+  const_reverse_iterator rend() const {
+    return const_reverse_iterator(begin());
+  }
+};
+
+template <typename T, typename Compare, typename Allocator>
+IndexedList<T, Compare, Allocator>::IndexedList(const Compare& compare,
+                                                const Allocator& alloc)
+    : node_allocator_(alloc),
+      link_allocator_(alloc),
+      compare_(compare) {
+  end_.links = end_links_;
+  end_.height = max_height;
+  reset();
+}
+
+template <typename T, typename Compare, typename Allocator>
+size_t IndexedList<T, Compare, Allocator>::random_height() {
+  seed_ ^= seed_ << 13;
+  seed_ ^= seed_ >> 7;
+  seed_ ^= seed_ << 17;
+  uint64_t bits = seed_;
+  size_t height = 1;
+  // each level keeps a quarter of the nodes below it
+  while (height < max_height && (bits & 3) == 0) {
+    ++height;
+    bits >>= 2;
+  }
+  return height;
+}
+
+template <typename T, typename Compare, typename Allocator>
+void IndexedList<T, Compare, Allocator>::reset() {
+  end_links_[0] = {&end_, &end_, 1};
+  size_ = 0;
+  levels_ = 1;
+}
+
+template <typename T, typename Compare, typename Allocator>
+void IndexedList<T, Compare, Allocator>::steal(IndexedList& other) {
+  if (other.size_ == 0) {
+    return;
+  }
+  size_ = other.size_;
+  levels_ = other.levels_;
+  for (size_t level = 0; level < levels_; ++level) {
+    Link& link = end_links_[level];
+    link = other.end_links_[level];
+    if (link.next == &other.end_) {
+      link.next = &end_;
+      link.previous = &end_;
+      continue;
+    }
+    link.next->links[level].previous = &end_;
+    link.previous->links[level].next = &end_;
+  }
+  other.reset();
+}
+
+template <typename T, typename Compare, typename Allocator>
+template <typename... Args>
+typename IndexedList<T, Compare, Allocator>::BaseNode*
+IndexedList<T, Compare, Allocator>::make_node(Args&&... args) {
+  size_t height = random_height();
+  Link* links = link_allocator_traits::allocate(link_allocator_, height);
+  Node* node;
+  try {
+    node = node_allocator_traits::allocate(node_allocator_, 1);
+  } catch (...) {
+    link_allocator_traits::deallocate(link_allocator_, links, height);
+    throw;
+  }
+  try {
+    node_allocator_traits::construct(node_allocator_, node,
+                                     std::forward<Args>(args)...);
+  } catch (...) {
+    node_allocator_traits::deallocate(node_allocator_, node, 1);
+    link_allocator_traits::deallocate(link_allocator_, links, height);
+    throw;
+  }
+  node->links = links;
+  node->height = height;
+  return node;
+}
+
+template <typename T, typename Compare, typename Allocator>
+void IndexedList<T, Compare, Allocator>::free_node(BaseNode* base) {
+  Node* node = static_cast<Node*>(base);
+  Link* links = node->links;
+  size_t height = node->height;
+  node_allocator_traits::destroy(node_allocator_, node);
+  node_allocator_traits::deallocate(node_allocator_, node, 1);
+  link_allocator_traits::deallocate(link_allocator_, links, height);
+}
+
+// Walks back from the new position, climbing to the closest taller node at
+// each level; each level costs an expected constant number of steps.
+template <typename T, typename Compare, typename Allocator>
+void IndexedList<T, Compare, Allocator>::link_before(BaseNode* position,
+                                                     BaseNode* node) {
+  for (; levels_ < node->height; ++levels_) {
+    end_links_[levels_] = {&end_, &end_, size_ + 1};
+  }
+  BaseNode* current = position->links[0].previous;
+  size_t distance = 1;
+  for (size_t level = 0; level < levels_; ++level) {
+    while (current->height <= level) {
+      BaseNode* previous = current->links[level - 1].previous;
+      distance += previous->links[level - 1].width;
+      current = previous;
+    }
+    Link& link = current->links[level];
+    if (level < node->height) {
+      node->links[level] = {link.next, current, link.width + 1 - distance};
+      link.next->links[level].previous = node;
+      link.next = node;
+      link.width = distance;
+    } else {
+      ++link.width;
+    }
+  }
+  ++size_;
+}
+
+template <typename T, typename Compare, typename Allocator>
+void IndexedList<T, Compare, Allocator>::unlink(BaseNode* node) {
+  BaseNode* current = node->links[0].previous;
+  for (size_t level = 0; level < levels_; ++level) {
+    while (current->height <= level) {
+      current = current->links[level - 1].previous;
+    }
+    Link& link = current->links[level];
+    if (level < node->height) {
+      link.next = node->links[level].next;
+      link.next->links[level].previous = current;
+      link.width += node->links[level].width - 1;
+    } else {
+      --link.width;
+    }
+  }
+  --size_;
+}
+
+template <typename T, typename Compare, typename Allocator>
+IndexedList<T, Compare, Allocator>::IndexedList(const IndexedList& other)
+    : node_allocator_(
+          node_allocator_traits::select_on_container_copy_construction(
+              other.node_allocator_)),
+      link_allocator_(node_allocator_),
+      compare_(other.compare_) {
+  end_.links = end_links_;
+  end_.height = max_height;
+  reset();
+  try {
+    for (const T& value : other) {
+      push_back(value);
+    }
+  } catch (...) {
+    clear();
+    throw;
+  }
+}
+
+template <typename T, typename Compare, typename Allocator>
+IndexedList<T, Compare, Allocator>::IndexedList(IndexedList&& other) noexcept
+    : node_allocator_(std::move(other.node_allocator_)),
+      link_allocator_(std::move(other.link_allocator_)),
+      compare_(other.compare_) {
+  end_.links = end_links_;
+  end_.height = max_height;
+  reset();
+  steal(other);
+}
+
+template <typename T, typename Compare, typename Allocator>
+IndexedList<T, Compare, Allocator>&
+IndexedList<T, Compare, Allocator>::operator=(const IndexedList& other) {
+  if (&other == this) {
+    return *this;
+  }
+  constexpr bool propagate =
+      node_allocator_traits::propagate_on_container_copy_assignment::value;
+  IndexedList tmp(other.compare_,
+                  propagate ? other.get_allocator() : get_allocator());
+  for (const T& value : other) {
+    tmp.push_back(value);
+  }
+  clear();
+  if constexpr (propagate) {
+    node_allocator_ = other.node_allocator_;
+    link_allocator_ = other.link_allocator_;
+  }
+  compare_ = other.compare_;
+  steal(tmp);
+  return *this;
+}
+
+template <typename T, typename Compare, typename Allocator>
+IndexedList<T, Compare, Allocator>&
+IndexedList<T, Compare, Allocator>::operator=(IndexedList&& other) noexcept(
+    nothrow_move_assign) {
+  if (&other == this) {
+    return *this;
+  }
+  if (node_allocator_traits::propagate_on_container_move_assignment::value ||
+      node_allocator_ == other.node_allocator_) {
+    clear();
+    if constexpr (node_allocator_traits::
+                      propagate_on_container_move_assignment::value) {
+      node_allocator_ = std::move(other.node_allocator_);
+      link_allocator_ = std::move(other.link_allocator_);
+    }
+    compare_ = other.compare_;
+    steal(other);
+    return *this;
+  }
+  IndexedList tmp(other.compare_, get_allocator());
+  for (T& value : other) {
+    tmp.emplace(tmp.cend(), std::move(value));
+  }
+  clear();
+  compare_ = other.compare_;
+  steal(tmp);
+  other.clear();
+  return *this;
+}
+
+template <typename T, typename Compare, typename Allocator>
+void IndexedList<T, Compare, Allocator>::clear() {
+  BaseNode* node = end_links_[0].next;
+  while (node != &end_) {
+    BaseNode* next = node->links[0].next;
+    free_node(node);
+    node = next;
+  }
+  reset();
+}
+
+template <typename T, typename Compare, typename Allocator>
+template <typename... Args>
+typename IndexedList<T, Compare, Allocator>::iterator
+IndexedList<T, Compare, Allocator>::emplace(const_iterator position,
+                                            Args&&... args) {
+  BaseNode* node = make_node(std::forward<Args>(args)...);
+  link_before(position.node_, node);
+  return iterator(node);
+}
+
+template <typename T, typename Compare, typename Allocator>
+typename IndexedList<T, Compare, Allocator>::iterator
+IndexedList<T, Compare, Allocator>::erase(const_iterator position) {
+  BaseNode* next = position.node_->links[0].next;
+  unlink(position.node_);
+  free_node(position.node_);
+  return iterator(next);
+}
+
+template <typename T, typename Compare, typename Allocator>
+typename IndexedList<T, Compare, Allocator>::iterator
+IndexedList<T, Compare, Allocator>::nth(size_t index) {
+  const_iterator result = std::as_const(*this).nth(index);
+  return iterator(result.node_);
+}
+
+// end() when index is out of range
+template <typename T, typename Compare, typename Allocator>
+typename IndexedList<T, Compare, Allocator>::const_iterator
+IndexedList<T, Compare, Allocator>::nth(size_t index) const {
+  if (index >= size_) {
+    return end();
+  }
+  const BaseNode* current = &end_;
+  size_t position = 0;
+  for (size_t level = levels_; level-- > 0;) {
+    const Link* link = &current->links[level];
+    while (link->next != &end_ && position + link->width <= index + 1) {
+      position += link->width;
+      current = link->next;
+      link = &current->links[level];
+    }
+  }
+  return const_iterator(current);
+}
+
+template <typename T, typename Compare, typename Allocator>
+size_t IndexedList<T, Compare, Allocator>::rank(
+    const_iterator position) const {
+  const BaseNode* current = position.node_;
+  if (current == &end_) {
+    return size_;
+  }
+  size_t distance = 0;
+  while (current != &end_) {
+    const Link& link = current->links[current->height - 1];
+    distance += link.previous->links[current->height - 1].width;
+    current = link.previous;
+  }
+  return distance - 1;
+}
+
+template <typename T, typename Compare, typename Allocator>
+typename IndexedList<T, Compare, Allocator>::iterator
+IndexedList<T, Compare, Allocator>::lower_bound(const T& key) {
+  const_iterator result = std::as_const(*this).lower_bound(key);
+  return iterator(result.node_);
+}
+
+template <typename T, typename Compare, typename Allocator>
+typename IndexedList<T, Compare, Allocator>::const_iterator
+IndexedList<T, Compare, Allocator>::lower_bound(const T& key) const {
+  const BaseNode* current = &end_;
+  for (size_t level = levels_; level-- > 0;) {
+    while (current->links[level].next != &end_ &&
+           compare_(value_of(current->links[level].next), key)) {
+      current = current->links[level].next;
+    }
+  }
+  return const_iterator(current->links[0].next);
+}
+
+template <typename T, typename Compare, typename Allocator>
+typename IndexedList<T, Compare, Allocator>::iterator
+IndexedList<T, Compare, Allocator>::upper_bound(const T& key) {
+  const_iterator result = std::as_const(*this).upper_bound(key);
+  return iterator(result.node_);
+}
+
+template <typename T, typename Compare, typename Allocator>
+typename IndexedList<T, Compare, Allocator>::const_iterator
+IndexedList<T, Compare, Allocator>::upper_bound(const T& key) const {
+  const BaseNode* current = &end_;
+  for (size_t level = levels_; level-- > 0;) {
+    while (current->links[level].next != &end_ &&
+           !compare_(key, value_of(current->links[level].next))) {
+      current = current->links[level].next;
+    }
+  }
+  return const_iterator(current->links[0].next);
+}
@@ -0,0 +1,203 @@
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "indexed_list.h"
+#include "stackallocator.h"
+
+#ifndef NO_TEST
+
+// NOLINTBEGIN
+
+constexpr size_t STORAGE_SIZE = 50'000'000;
+StackStorage<STORAGE_SIZE> STATIC_STORAGE;
+
+template <typename List>
+void CheckAgainst(const List& lst, const std::vector<int>& model) {
+    assert(lst.size() == model.size());
+    assert(std::equal(lst.begin(), lst.end(), model.begin(), model.end()));
+    assert(std::equal(lst.rbegin(), lst.rend(), model.rbegin(), model.rend()));
+    size_t index = 0;
+    for (auto it = lst.begin(); it != lst.end(); ++it, ++index) {
+        assert(lst.rank(it) == index);
+        assert(lst.nth(index) == it);
+    }
+    assert(lst.rank(lst.end()) == model.size());
+    assert(lst.nth(model.size()) == lst.end());
+}
+
+void TestPositional() {
+    std::mt19937 gen(46);
+    IndexedList<int> lst;
+    std::vector<int> model;
+    for (int i = 0; i < 3'000; ++i) {
+        size_t position = gen() % (model.size() + 1);
+        switch (gen() % 4) {
+            case 0:
+                lst.push_back(i);
+                model.push_back(i);
+                break;
+            case 1:
+                lst.push_front(i);
+                model.insert(model.begin(), i);
+                break;
+            case 2:
+                lst.insert(lst.nth(position), i);
+                model.insert(model.begin() + position, i);
+                break;
+            default:
+                if (model.empty()) {
+                    break;
+                }
+                position %= model.size();
+                lst.insert_after(lst.nth(position), i);
+                model.insert(model.begin() + position + 1, i);
+        }
+        if (i % 3 == 2 && !model.empty()) {
+            size_t victim = gen() % model.size();
+            auto next = lst.erase(lst.nth(victim));
+            model.erase(model.begin() + victim);
+            assert(lst.rank(next) == victim);
+        }
+    }
+    CheckAgainst(lst, model);
+
+    lst.pop_front();
+    lst.pop_back();
+    model.erase(model.begin());
+    model.pop_back();
+    CheckAgainst(lst, model);
+
+    IndexedList<int> copy = lst;
+    CheckAgainst(copy, model);
+    IndexedList<int> moved = std::move(copy);
+    assert(copy.empty());
+    CheckAgainst(moved, model);
+    copy = moved;
+    moved = std::move(lst);
+    CheckAgainst(copy, model);
+    CheckAgainst(moved, model);
+    moved.clear();
+    assert(moved.empty() && moved.begin() == moved.end());
+    moved.push_back(1);
+    assert(moved.size() == 1 && *moved.nth(0) == 1);
+}
+
+void TestOrdered() {
+    using Alloc = StackAllocator<std::string, STORAGE_SIZE>;
+    std::mt19937 gen(47);
+    IndexedList<std::string, std::less<std::string>, Alloc> lst{Alloc(STATIC_STORAGE)};
+    std::vector<std::string> model;
+    for (int i = 0; i < 5'000; ++i) {
+        std::string value = std::to_string(gen() % 2'000);
+        lst.insert(value);
+        model.insert(std::upper_bound(model.begin(), model.end(), value), value);
+    }
+    assert(std::equal(lst.begin(), lst.end(), model.begin(), model.end()));
+
+    for (int i = 0; i < 2'000; ++i) {
+        std::string key = std::to_string(i);
+        size_t lower = std::lower_bound(model.begin(), model.end(), key) - model.begin();
+        size_t upper = std::upper_bound(model.begin(), model.end(), key) - model.begin();
+        assert(lst.rank(lst.lower_bound(key)) == lower);
+        assert(lst.rank(lst.upper_bound(key)) == upper);
+    }
+    const auto& view = lst;
+    assert(*view.nth(0) == model.front() && view.lower_bound("~") == view.end());
+}
+
+void Benchmark(size_t size) {
+    using namespace std::chrono;
+
+    const size_t queries = 100'000;
+    const size_t linear_queries = 20;
+    std::mt19937 gen(48);
+    std::vector<size_t> positions(queries);
+    for (auto& position : positions) {
+        position = gen() % size;
+    }
+
+    auto start = high_resolution_clock::now();
+    IndexedList<int> indexed;
+    for (size_t i = 0; i < size; ++i) {
+        indexed.push_back(static_cast<int>(2 * i));
+    }
+    auto built = high_resolution_clock::now();
+
+    long long checksum = 0;
+    for (size_t position : positions) {
+        checksum += *indexed.nth(position);
+    }
+    auto nth_done = high_resolution_clock::now();
+    for (size_t position : positions) {
+        checksum += indexed.rank(indexed.lower_bound(static_cast<int>(position)));
+    }
+    auto search_done = high_resolution_clock::now();
+    for (size_t i = 0; i < queries; ++i) {
+        indexed.insert_after(indexed.nth(positions[i]), -1);
+    }
+    auto insert_done = high_resolution_clock::now();
+    assert(indexed.size() == size + queries);
+    indexed.clear();
+
+    List<int> plain;
+    for (size_t i = 0; i < size; ++i) {
+        plain.push_back(static_cast<int>(2 * i));
+    }
+    auto plain_built = high_resolution_clock::now();
+    for (size_t i = 0; i < linear_queries; ++i) {
+        auto it = plain.begin();
+        std::advance(it, positions[i]);
+        checksum -= *it;
+    }
+    auto linear_done = high_resolution_clock::now();
+    assert(checksum != 0);
+
+    auto per_query = [](auto from, auto to, size_t count) {
+        return duration_cast<nanoseconds>(to - from).count() / static_cast<long long>(count);
+    };
+    std::cerr << "  " << size << " nodes: build " << duration_cast<milliseconds>(built - start).count()
+              << " ms, nth " << per_query(built, nth_done, queries) << " ns, lower_bound + rank "
+              << per_query(nth_done, search_done, queries) << " ns, nth + insert_after "
+              << per_query(search_done, insert_done, queries) << " ns; List advance "
+              << per_query(plain_built, linear_done, linear_queries) << " ns" << std::endl;
+}
+
+// indexed_list [benchmark sizes...]; without arguments only the 1e5 point
+// runs, e.g. `indexed_list 100000 1000000 10000000` for the full curve
+int main(int argc, char** argv) {
+    TestPositional();
+    std::cerr << "Test 1 (positional insert, erase, nth and rank) passed." << std::endl;
+
+    TestOrdered();
+    std::cerr << "Test 2 (ordered insert and bounds) passed." << std::endl;
+
+    std::vector<size_t> sizes;
+    for (int i = 1; i < argc; ++i) {
+        sizes.push_back(std::stoul(argv[i]));
+    }
+    if (sizes.empty()) {
+        sizes.push_back(100'000);
+    }
+    for (size_t size : sizes) {
+        Benchmark(size);
+    }
+    std::cerr << "Test 3 (benchmark against List) passed." << std::endl;
+
+    std::cout << 0;
+}
+
+// NOLINTEND
+
+#else
+
+int main() {
+    std::cerr << "Tests are turned off!\n";
+}
+
+#endif
@@ -0,0 +1,276 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+class IntrusiveHook {
+ private:
+  IntrusiveHook* next_;
+  IntrusiveHook* previous_;
+  // the object this hook is a member of, recorded when it is linked
+  void* owner_ = nullptr;
+
+  void link_before(IntrusiveHook* position) {
+    if (position == this) {
+      return;
+    }
+    unlink();
+    previous_ = position->previous_;
+    next_ = position;
+    previous_->next_ = this;
+    position->previous_ = this;
+  }
+
+  template <typename T, IntrusiveHook T::*Hook>
+  friend class IntrusiveList;
+
+ public:
+  IntrusiveHook()
+      : next_(this),
+        previous_(this) {
+  }
+  IntrusiveHook(const IntrusiveHook&)
+      : IntrusiveHook() {
+  }
+  IntrusiveHook& operator=(const IntrusiveHook&) {
+    return *this;
+  }
+  ~IntrusiveHook() {
+    unlink();
+  }
+
+  bool linked() const {
+    return next_ != this;
+  }
+
+  void unlink() {
+    next_->previous_ = previous_;
+    previous_->next_ = next_;
+    next_ = this;
+    previous_ = this;
+  }
+};
+
+template <typename T, IntrusiveHook T::*Hook>
+class IntrusiveList {
+ private:
+  IntrusiveHook end_;
+
+  static T* owner(const IntrusiveHook* hook) {
+    return static_cast<T*>(hook->owner_);
+  }
+
+  static IntrusiveHook* hook_of(const T& value) {
+    return const_cast<IntrusiveHook*>(&(value.*Hook));
+  }
+
+  // hook_of() for a value about to be linked into a list
+  static IntrusiveHook* attach(T& value) {
+    IntrusiveHook* hook = hook_of(value);
+    hook->owner_ = &value;
+    return hook;
+  }
+
+  template <bool is_constant>
+  class base_iterator {
+   public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = std::conditional_t<is_constant, const T, T>;
+    using pointer = std::conditional_t<is_constant, const T*, T*>;
+    using reference = std::conditional_t<is_constant, const T&, T&>;
+    using difference_type = int;
+
+   private:
+    IntrusiveHook* hook_;
+
+   public:
+    base_iterator() = delete;
+    base_iterator(const IntrusiveHook* hook)
+        : hook_(const_cast<IntrusiveHook*>(hook)) {
+    }
+
+    base_iterator& operator++() {
+      hook_ = hook_->next_;
+      return *this;
+    }
+    base_iterator operator++(int) {
+      base_iterator result = *this;
+      ++(*this);
+      return result;
+    }
+
+    base_iterator& operator--() {
+      hook_ = hook_->previous_;
+      return *this;
+    }
+    base_iterator operator--(int) {
+      base_iterator result = *this;
+      --(*this);
+      return result;
+    }
+
+    bool operator==(const base_iterator& other) const {
+      return hook_ == other.hook_;
+    }
+    bool operator!=(const base_iterator& other) const {
+      return hook_ != other.hook_;
+    }
+
+    operator base_iterator<true>() const {
+      return base_iterator<true>(hook_);
+    }
+
+    pointer operator->() const {
+      return owner(hook_);
+    }
+
+    reference operator*() const {
+      return *owner(hook_);
+    }
+
+    friend class IntrusiveList<T, Hook>;
+  };
+
+ public:
+  using iterator = base_iterator<false>;
+  using const_iterator = base_iterator<true>;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  IntrusiveList() = default;
+  IntrusiveList(const IntrusiveList&) = delete;
+  IntrusiveList& operator=(const IntrusiveList&) = delete;
+  IntrusiveList(IntrusiveList&& other) noexcept;
+  IntrusiveList& operator=(IntrusiveList&& other) noexcept;
+  ~IntrusiveList() {
+    clear();
+  }
+
+  bool empty() const {
+    return !end_.linked();
+  }
+
+  size_t size() const;
+
+  void clear();
+
+  T& front() {
+    return *owner(end_.next_);
+  }
+  T& back() {
+    return *owner(end_.previous_);
+  }
+
+  void push_back(T& value) {
+    attach(value)->link_before(&end_);
+  }
+  void push_front(T& value) {
+    attach(value)->link_before(end_.next_);
+  }
+  void pop_back() {
+    end_.previous_->unlink();
+  }
+  void pop_front() {
+    end_.next_->unlink();
+  }
+
+  iterator insert(const_iterator position, T& value);
+  iterator erase(const_iterator position);
+
+  static void remove(T& value) {
+    hook_of(value)->unlink();
+  }
+
+  static iterator iterator_to(T& value) {
+    return iterator(hook_of(value));
+  }
+
+  iterator begin() {
+    return iterator(end_.next_);
+  }
+  const_iterator begin() const {
+    return const_iterator(end_.next_);
+  }
+  const_iterator cbegin() const {
+    return begin();
+  }
+  iterator end() {
+    return iterator(&end_);
+  }
+  const_iterator end() const {
+    return const_iterator(&end_);
+  }
+  const_iterator cend() const {
+    return end();
+  }
+
+  reverse_iterator rbegin() {
+    return reverse_iterator(end());
+  }
+  const_reverse_iterator rbegin() const {
+    return const_reverse_iterator(end());
+  }
+  reverse_iterator rend() {
+    return reverse_iterator(begin());
+  }
+  const_reverse_iterator rend() const {
+    return const_reverse_iterator(begin());
+  }
+};
+
+template <typename T, IntrusiveHook T::*Hook>
+IntrusiveList<T, Hook>::IntrusiveList(IntrusiveList&& other) noexcept {
+  if (other.empty()) {
+    return;
+  }
+  end_.link_before(&other.end_);
+  other.end_.unlink();
+}
+
+template <typename T, IntrusiveHook T::*Hook>
+IntrusiveList<T, Hook>& IntrusiveList<T, Hook>::operator=(
+    IntrusiveList&& other) noexcept {
+  if (&other == this) {
+    return *this;
+  }
+  clear();
+  if (!other.empty()) {
+    end_.link_before(&other.end_);
+    other.end_.unlink();
+  }
+  return *this;
+}
+
+template <typename T, IntrusiveHook T::*Hook>
+size_t IntrusiveList<T, Hook>::size() const {
+  size_t count = 0;
+  for (const IntrusiveHook* hook = end_.next_; hook != &end_;
+       hook = hook->next_) {
+    ++count;
+  }
+  return count;
+}
+
+template <typename T, IntrusiveHook T::*Hook>
+void IntrusiveList<T, Hook>::clear() {
+  while (!empty()) {
+    pop_front();
+  }
+}
+
+template <typename T, IntrusiveHook T::*Hook>
+typename IntrusiveList<T, Hook>::iterator IntrusiveList<T, Hook>::insert(
+    const_iterator position, T& value) {
+  IntrusiveHook* hook = attach(value);
+  hook->link_before(position.hook_);
+  return iterator(hook);
+}
+
+template <typename T, IntrusiveHook T::*Hook>
+typename IntrusiveList<T, Hook>::iterator IntrusiveList<T, Hook>::erase(
+    const_iterator position) {
+  IntrusiveHook* next = position.hook_->next_;
+  position.hook_->unlink();
+  return iterator(next);
+}
@@ -0,0 +1,223 @@
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "intrusive_list.h"
+#include "stackallocator.h"
+
+#ifndef NO_TEST
+
+// NOLINTBEGIN
+
+size_t heap_allocations = 0;
+
+void* operator new(size_t size) {
+    ++heap_allocations;
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+struct Task {
+    int id = 0;
+    std::string name;
+    IntrusiveHook queue_hook;
+    IntrusiveHook owner_hook;
+
+    Task(int id) : id(id), name("task " + std::to_string(id)) {}
+};
+
+using TaskQueue = IntrusiveList<Task, &Task::queue_hook>;
+using OwnerList = IntrusiveList<Task, &Task::owner_hook>;
+
+std::vector<int> Ids(const TaskQueue& queue) {
+    std::vector<int> ids;
+    for (const Task& task : queue) {
+        ids.push_back(task.id);
+    }
+    return ids;
+}
+
+void TestLinking() {
+    std::vector<Task> pool;
+    for (int i = 0; i < 10; ++i) {
+        pool.emplace_back(i);
+    }
+
+    size_t allocations = heap_allocations;
+    TaskQueue ready;
+    TaskQueue blocked;
+    OwnerList owned;
+    for (Task& task : pool) {
+        ready.push_back(task);
+        owned.push_front(task);
+    }
+    assert(heap_allocations == allocations);
+    assert(ready.size() == 10 && owned.size() == 10);
+    assert(ready.front().id == 0 && ready.back().id == 9);
+    assert(owned.front().id == 9);
+
+    TaskQueue::remove(pool[4]);
+    assert(!pool[4].queue_hook.linked() && pool[4].owner_hook.linked());
+    blocked.push_back(pool[4]);
+    blocked.push_back(pool[7]);
+    auto it = ready.erase(TaskQueue::iterator_to(pool[2]));
+    ready.insert(it, pool[2]);
+    ready.push_front(pool[9]);
+    ready.pop_back();
+    assert(heap_allocations == allocations);
+    assert(it->id == 3);
+    assert((Ids(ready) == std::vector<int>{9, 0, 1, 2, 3, 5, 6}));
+    assert((Ids(blocked) == std::vector<int>{4, 7}));
+    assert(std::find_if(ready.rbegin(), ready.rend(), [](const Task& t) { return t.id == 0; })->name == "task 0");
+
+    allocations = heap_allocations;
+    TaskQueue moved(std::move(ready));
+    ready = std::move(blocked);
+    assert(heap_allocations == allocations);
+    assert(!ready.empty() && blocked.empty());
+    assert(moved.size() == 7);
+    assert((Ids(ready) == std::vector<int>{4, 7}));
+
+    {
+        Task temporary(100);
+        moved.push_back(temporary);
+        assert(moved.size() == 8);
+    }
+    assert(moved.size() == 7 && moved.back().id == 6);
+
+    moved.clear();
+    assert(!pool[0].queue_hook.linked() && pool[0].owner_hook.linked());
+    owned.clear();
+    assert(!pool[0].owner_hook.linked());
+}
+
+struct Named {
+    std::string label;
+    virtual ~Named() = default;
+};
+
+// not standard layout: the owner cannot be found from the hook by offsetof
+struct Worker : virtual Named {
+    int shift = 0;
+    IntrusiveHook hook;
+
+    Worker(int shift) : shift(shift) {
+        label = "worker " + std::to_string(shift);
+    }
+};
+
+struct NightWorker : Worker {
+    long long overtime = 0;
+
+    NightWorker(int shift) : Worker(shift) {}
+};
+
+void TestVirtualBases() {
+    using Roster = IntrusiveList<Worker, &Worker::hook>;
+    Worker day(1);
+    NightWorker night(2);
+    Worker late(3);
+
+    Roster roster;
+    roster.push_back(day);
+    roster.push_back(night);
+    roster.insert(roster.end(), late);
+    std::vector<std::string> labels;
+    for (const Worker& worker : roster) {
+        labels.push_back(worker.label);
+    }
+    assert((labels == std::vector<std::string>{"worker 1", "worker 2", "worker 3"}));
+    assert(&roster.front() == &day && &*std::next(roster.begin()) == &night);
+    assert(static_cast<NightWorker&>(*std::next(roster.begin())).overtime == 0);
+    assert(roster.back().shift == 3);
+}
+
+struct Job {
+    long long payload = 0;
+    IntrusiveHook hook;
+};
+
+void CompareWithList() {
+    using namespace std::chrono;
+
+    std::vector<Job> jobs(100'000);
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        jobs[i].payload = static_cast<long long>(i);
+    }
+    std::mt19937 gen(41);
+    std::vector<size_t> order(jobs.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::shuffle(order.begin(), order.end(), gen);
+
+    long long intrusive_sum = 0;
+    long long list_sum = 0;
+    auto start = high_resolution_clock::now();
+    for (int round = 0; round < 20; ++round) {
+        IntrusiveList<Job, &Job::hook> queue;
+        for (size_t index : order) {
+            queue.push_back(jobs[index]);
+        }
+        while (!queue.empty()) {
+            intrusive_sum += queue.front().payload;
+            queue.pop_front();
+        }
+    }
+    auto intrusive_done = high_resolution_clock::now();
+    size_t allocations = heap_allocations;
+    for (int round = 0; round < 20; ++round) {
+        List<Job*> queue;
+        for (size_t index : order) {
+            queue.push_back(&jobs[index]);
+        }
+        while (queue.size() > 0) {
+            list_sum += (*queue.begin())->payload;
+            queue.pop_front();
+        }
+    }
+    auto list_done = high_resolution_clock::now();
+    assert(intrusive_sum == list_sum);
+    std::cerr << " 20 x 100'000 enqueue/dequeue: IntrusiveList " << duration_cast<milliseconds>(intrusive_done - start).count()
+              << " ms, List<Job*> " << duration_cast<milliseconds>(list_done - intrusive_done).count() << " ms with "
+              << heap_allocations - allocations << " heap allocations" << std::endl;
+}
+
+int main() {
+    TestLinking();
+    std::cerr << "Test 1 (linking, unlinking and moving without allocation) passed." << std::endl;
+
+    TestVirtualBases();
+    std::cerr << "Test 2 (elements with virtual bases) passed." << std::endl;
+
+    CompareWithList();
+    std::cerr << "Test 3 (comparison with List) passed." << std::endl;
+
+    std::cout << 0;
+}
+
+// NOLINTEND
+
+#else
+
+int main() {
+    std::cerr << "Tests are turned off!\n";
+}
+
+#endif
@@ -0,0 +1,223 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string>
+#include <system_error>
+#include <type_traits>
+
+#include "offset_ptr.h"
+
+// Bump arena that lives at the start of a mapped file. Everything it hands out
+// is addressed relative to the mapping, so it holds no absolute pointers.
+class MappedArena {
+ private:
+  static const uint64_t signature = 0x314b545350414d4dULL;
+
+  uint64_t signature_ = signature;
+  size_t capacity_;
+  size_t shift_ = 0;
+  OffsetPtr<void> root_;
+
+  char* data() {
+    return reinterpret_cast<char*>(this + 1);
+  }
+
+  friend class MappedStackStorage;
+
+ public:
+  using partial_deallocation = std::true_type;
+
+  explicit MappedArena(size_t capacity)
+      : capacity_(capacity) {
+  }
+  MappedArena(const MappedArena&) = delete;
+  MappedArena& operator=(const MappedArena&) = delete;
+
+  template <typename T>
+  T* allocate(size_t n);
+  template <typename T>
+  void deallocate(T* ptr, size_t n);
+
+  size_t used() const {
+    return shift_;
+  }
+  size_t capacity() const {
+    return capacity_;
+  }
+
+  template <typename T>
+  T* root() const {
+    return static_cast<T*>(root_.get());
+  }
+  void set_root(void* root) {
+    root_ = root;
+  }
+};
+
+template <typename T>
+T* MappedArena::allocate(size_t n) {
+  void* result = data() + shift_;
+  size_t left = capacity_ - shift_;
+  result = std::align(alignof(T), n * sizeof(T), result, left);
+  if (result == nullptr) {
+    throw std::bad_alloc();
+  }
+  shift_ = reinterpret_cast<char*>(result) - data() + n * sizeof(T);
+  return reinterpret_cast<T*>(result);
+}
+
+template <typename T>
+void MappedArena::deallocate(T* ptr, size_t n) {
+  char* begin = reinterpret_cast<char*>(ptr);
+  if (begin + n * sizeof(T) == data() + shift_) {
+    shift_ = begin - data();
+  }
+}
+
+// Maps (and creates if needed) a file holding a MappedArena. Reopening a file
+// written by an earlier run keeps its contents and root object.
+class MappedStackStorage {
+ private:
+  int fd_ = -1;
+  void* mapping_ = MAP_FAILED;
+  size_t bytes_;
+  bool reopened_ = false;
+
+  [[noreturn]] void fail(const char* what);
+
+ public:
+  MappedStackStorage(const std::string& path, size_t capacity);
+  MappedStackStorage(const MappedStackStorage&) = delete;
+  MappedStackStorage& operator=(const MappedStackStorage&) = delete;
+  ~MappedStackStorage();
+
+  MappedArena& arena() const {
+    return *static_cast<MappedArena*>(mapping_);
+  }
+
+  bool reopened() const {
+    return reopened_;
+  }
+
+  template <typename T>
+  T* allocate(size_t n) {
+    return arena().template allocate<T>(n);
+  }
+  template <typename T>
+  void deallocate(T* ptr, size_t n) {
+    arena().deallocate(ptr, n);
+  }
+
+  size_t used() const {
+    return arena().used();
+  }
+
+  template <typename T>
+  T* root() const {
+    return arena().template root<T>();
+  }
+  void set_root(void* root) {
+    arena().set_root(root);
+  }
+
+  void flush();
+};
+
+inline void MappedStackStorage::fail(const char* what) {
+  int error = errno;
+  if (mapping_ != MAP_FAILED) {
+    munmap(mapping_, bytes_);
+  }
+  if (fd_ != -1) {
+    close(fd_);
+  }
+  throw std::system_error(error, std::generic_category(), what);
+}
+
+inline MappedStackStorage::MappedStackStorage(const std::string& path,
+                                              size_t capacity)
+    : bytes_(sizeof(MappedArena) + capacity) {
+  fd_ = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+  if (fd_ == -1) {
+    fail("open");
+  }
+  struct stat status;
+  if (fstat(fd_, &status) == -1) {
+    fail("fstat");
+  }
+  bool existing = static_cast<size_t>(status.st_size) == bytes_;
+  if (!existing && ftruncate(fd_, static_cast<off_t>(bytes_)) == -1) {
+    fail("ftruncate");
+  }
+  mapping_ =
+      mmap(nullptr, bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+  if (mapping_ == MAP_FAILED) {
+    fail("mmap");
+  }
+  MappedArena* arena = static_cast<MappedArena*>(mapping_);
+  reopened_ = existing && arena->signature_ == MappedArena::signature &&
+              arena->capacity_ == capacity;
+  if (!reopened_) {
+    ::new (mapping_) MappedArena(capacity);
+  }
+}
+
+inline MappedStackStorage::~MappedStackStorage() {
+  munmap(mapping_, bytes_);
+  close(fd_);
+}
+
+inline void MappedStackStorage::flush() {
+  if (msync(mapping_, bytes_, MS_SYNC) == -1) {
+    throw std::system_error(errno, std::generic_category(), "msync");
+  }
+}
+
+template <typename T>
+class MappedAllocator {
+ public:
+  OffsetPtr<MappedArena> arena_;
+  using value_type = T;
+  using pointer = OffsetPtr<T>;
+  using const_pointer = OffsetPtr<const T>;
+  using partial_deallocation = std::true_type;
+
+  MappedAllocator(MappedArena& arena)
+      : arena_(&arena) {
+  }
+  MappedAllocator(MappedStackStorage& storage)
+      : arena_(&storage.arena()) {
+  }
+
+  template <typename U>
+  MappedAllocator(const MappedAllocator<U>& other)
+      : arena_(other.arena_) {
+  }
+
+  pointer allocate(size_t n) {
+    return arena_->template allocate<T>(n);
+  }
+
+  void deallocate(pointer ptr, size_t n) {
+    arena_->deallocate(ptr.get(), n);
+  }
+
+  template <typename U>
+  bool operator==(const MappedAllocator<U>& other) const {
+    return arena_.get() == other.arena_.get();
+  }
+
+  template <typename U>
+  bool operator!=(const MappedAllocator<U>& other) const {
+    return !(*this == other);
+  }
+};
@@ -0,0 +1,179 @@
+#include <sys/mman.h>
+
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <new>
+#include <string>
+
+#include "mapped_storage.h"
+#include "offset_ptr.h"
+#include "stackallocator.h"
+
+#ifndef NO_TEST
+
+// NOLINTBEGIN
+
+struct Record {
+    int key = 0;
+    long long value = 0;
+
+    Record(int key, long long value) : key(key), value(value) {}
+};
+
+using Alloc = MappedAllocator<Record>;
+using PersistentList = List<Record, Alloc>;
+
+constexpr size_t CAPACITY = 64'000'000;
+
+std::string StoragePath() {
+    return (std::filesystem::temp_directory_path() / "mapped_storage_test.bin").string();
+}
+
+void TestOffsetPtr() {
+    struct Pair {
+        OffsetPtr<int> first;
+        OffsetPtr<int> second;
+    };
+    alignas(Pair) unsigned char region[2 * sizeof(Pair) + 4 * sizeof(int)];
+    int* values = reinterpret_cast<int*>(region + 2 * sizeof(Pair));
+    for (int i = 0; i < 4; ++i) {
+        values[i] = i * 10;
+    }
+    Pair* pair = ::new (region) Pair;
+    assert(pair->first == nullptr && !pair->first);
+    pair->first = values;
+    pair->second = pair->first;
+    ++pair->second;
+    assert(*pair->first == 0 && *pair->second == 10 && pair->second[2] == 30);
+    assert(pair->second - pair->first == 1);
+
+    // links survive moving the whole region
+    alignas(Pair) unsigned char moved[sizeof(region)];
+    std::memcpy(moved, region, sizeof(region));
+    Pair* copy = reinterpret_cast<Pair*>(moved);
+    assert(copy->first.get() == reinterpret_cast<int*>(moved + 2 * sizeof(Pair)));
+    assert(*copy->second == 10);
+
+    OffsetPtr<void> erased = pair->first;
+    assert(static_cast<OffsetPtr<int>>(erased).get() == values);
+    assert(std::pointer_traits<OffsetPtr<int>>::pointer_to(values[3]).get() == values + 3);
+}
+
+void TestReopen() {
+    std::string path = StoragePath();
+    std::filesystem::remove(path);
+
+    void* first_address = nullptr;
+    {
+        MappedStackStorage storage(path, CAPACITY);
+        assert(!storage.reopened());
+        auto* lst = ::new (storage.allocate<PersistentList>(1)) PersistentList(Alloc(storage));
+        storage.set_root(lst);
+        for (int i = 0; i < 1'000; ++i) {
+            lst->push_back(Record(i, i * 1'000LL));
+        }
+        lst->push_front(Record(-1, 0));
+        storage.flush();
+        first_address = &storage.arena();
+    }
+
+    // keep the old address busy so the file lands somewhere else
+    void* blocker = mmap(first_address, CAPACITY, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    assert(blocker != MAP_FAILED);
+    {
+        MappedStackStorage storage(path, CAPACITY);
+        assert(storage.reopened());
+        if (blocker == first_address) {
+            assert(&storage.arena() != first_address);
+        }
+        PersistentList& lst = *storage.root<PersistentList>();
+        assert(lst.size() == 1'001);
+        assert(lst.begin()->key == -1 && lst.rbegin()->key == 999);
+        int expected = -1;
+        for (const Record& record : lst) {
+            assert(record.key == expected);
+            ++expected;
+        }
+        expected = 999;
+        for (auto it = lst.rbegin(); it != lst.rend(); ++it) {
+            assert(it->key == expected);
+            --expected;
+        }
+
+        lst.pop_front();
+        lst.push_back(Record(1'000, 0));
+        lst.sort([](const Record& a, const Record& b) { return a.key > b.key; });
+        lst.reverse();
+    }
+    munmap(blocker, CAPACITY);
+    {
+        MappedStackStorage storage(path, CAPACITY);
+        assert(storage.reopened());
+        PersistentList& lst = *storage.root<PersistentList>();
+        assert(lst.size() == 1'001 && lst.begin()->key == 0 && lst.rbegin()->key == 1'000);
+        lst.~PersistentList();
+    }
+    {
+        MappedStackStorage storage(path, CAPACITY / 2);
+        assert(!storage.reopened() && storage.used() == 0);
+    }
+    std::filesystem::remove(path);
+}
+
+void CompareReopenWithRebuild() {
+    using namespace std::chrono;
+
+    std::string path = StoragePath();
+    std::filesystem::remove(path);
+    const int size = 1'000'000;
+
+    auto start = high_resolution_clock::now();
+    {
+        MappedStackStorage storage(path, CAPACITY);
+        auto* lst = ::new (storage.allocate<PersistentList>(1)) PersistentList(Alloc(storage));
+        storage.set_root(lst);
+        for (int i = 0; i < size; ++i) {
+            lst->push_back(Record(i, i));
+        }
+    }
+    auto built = high_resolution_clock::now();
+    long long last = 0;
+    {
+        MappedStackStorage storage(path, CAPACITY);
+        PersistentList& lst = *storage.root<PersistentList>();
+        assert(lst.size() == static_cast<size_t>(size));
+        last = lst.rbegin()->value;
+    }
+    auto reopened = high_resolution_clock::now();
+    assert(last == size - 1);
+    std::filesystem::remove(path);
+
+    std::cerr << " " << size << " nodes: build " << duration_cast<milliseconds>(built - start).count()
+              << " ms, reopen " << duration_cast<microseconds>(reopened - built).count() << " us" << std::endl;
+}
+
+int main() {
+    TestOffsetPtr();
+    std::cerr << "Test 1 (offset pointers survive relocation) passed." << std::endl;
+
+    TestReopen();
+    std::cerr << "Test 2 (List reopened from a file mapped at another address) passed." << std::endl;
+
+    CompareReopenWithRebuild();
+    std::cerr << "Test 3 (reopen vs rebuild) passed." << std::endl;
+
+    std::cout << 0;
+}
+
+// NOLINTEND
+
+#else
+
+int main() {
+    std::cerr << "Tests are turned off!\n";
+}
+
+#endif
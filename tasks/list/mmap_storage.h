@@ -0,0 +1,185 @@
+#pragma once
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+#include "arena_allocator.h"
+#include "numa_topology.h"
+#include "stackstorage.h"
+
+struct PageOptions {
+  // touch every page up front, so allocate() never takes a page fault
+  bool prefault = true;
+  // ask for transparent huge pages on a 2 MiB aligned range
+  bool huge_pages = false;
+  // bind the pages to this NUMA node before they are touched; -1 leaves
+  // placement to the first thread that writes them
+  int numa_node = -1;
+};
+
+// StackStorage whose buffer is an anonymous mapping instead of a member, for
+// arenas far too large for the stack or a static.
+template <size_t N, typename Stats = NoStackStats>
+class MmapStackStorage {
+ private:
+  static const size_t huge_page_size = size_t(2) << 20;
+
+  char* data_;
+  size_t mapped_;
+  size_t shift_ = 0;
+  bool huge_pages_ = false;
+  int numa_node_ = -1;
+  [[no_unique_address]] Stats stats_;
+
+  void map(PageOptions options);
+
+ public:
+  class Checkpoint {
+   private:
+    size_t shift_;
+
+    explicit Checkpoint(size_t shift)
+        : shift_(shift) {
+    }
+
+    friend class MmapStackStorage<N, Stats>;
+  };
+
+  using partial_deallocation = std::true_type;
+
+  explicit MmapStackStorage(PageOptions options = PageOptions()) {
+    map(options);
+  }
+  MmapStackStorage(const MmapStackStorage&) = delete;
+  MmapStackStorage& operator=(const MmapStackStorage&) = delete;
+  ~MmapStackStorage() {
+    munmap(data_, mapped_);
+  }
+
+  template <typename T>
+  T* allocate(size_t n);
+  template <typename T>
+  void deallocate(T* ptr, size_t n);
+
+  size_t used() const {
+    return shift_;
+  }
+
+  // whether the kernel accepted the huge page advice for the buffer
+  bool huge_pages() const {
+    return huge_pages_;
+  }
+
+  // node the buffer is bound to, or -1 when it was not asked for or the
+  // kernel refused the binding
+  int numa_node() const {
+    return numa_node_;
+  }
+
+  bool owns(const void* ptr) const {
+    const char* byte = static_cast<const char*>(ptr);
+    return byte >= data_ && byte < data_ + mapped_;
+  }
+
+  Checkpoint mark() const {
+    return Checkpoint(shift_);
+  }
+
+  void rewind(Checkpoint checkpoint) {
+    shift_ = std::min(checkpoint.shift_, shift_);
+  }
+
+  const Stats& stats() const {
+    return stats_;
+  }
+};
+
+template <size_t N, typename Stats>
+void MmapStackStorage<N, Stats>::map(PageOptions options) {
+  // MAP_POPULATE would fault the pages in before the advice or the binding
+  // is applied
+  bool populate =
+      options.prefault && !options.huge_pages && options.numa_node < 0;
+  if (!options.huge_pages) {
+    mapped_ = N;
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+    if (populate) {
+      flags |= MAP_POPULATE;
+    }
+    void* memory =
+        mmap(nullptr, mapped_, PROT_READ | PROT_WRITE, flags, -1, 0);
+    if (memory == MAP_FAILED) {
+      throw std::bad_alloc();
+    }
+    data_ = static_cast<char*>(memory);
+  } else {
+    // over-map and trim, so the buffer starts on a huge page boundary
+    mapped_ = (N + huge_page_size - 1) / huge_page_size * huge_page_size;
+    size_t reserved = mapped_ + huge_page_size;
+    void* memory = mmap(nullptr, reserved, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+      throw std::bad_alloc();
+    }
+    uintptr_t begin = reinterpret_cast<uintptr_t>(memory);
+    uintptr_t aligned =
+        (begin + huge_page_size - 1) / huge_page_size * huge_page_size;
+    if (aligned != begin) {
+      munmap(memory, aligned - begin);
+    }
+    munmap(reinterpret_cast<char*>(aligned) + mapped_,
+           begin + reserved - aligned - mapped_);
+    data_ = reinterpret_cast<char*>(aligned);
+#ifdef MADV_HUGEPAGE
+    huge_pages_ = madvise(data_, mapped_, MADV_HUGEPAGE) == 0;
+#endif
+  }
+
+  if (options.numa_node >= 0 &&
+      bind_to_numa_node(data_, mapped_, options.numa_node)) {
+    numa_node_ = options.numa_node;
+  }
+  if (options.prefault && !populate) {
+    // one touch per small page even with the advice: the kernel may still
+    // fall back to small pages for parts of the range
+    const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    for (size_t offset = 0; offset < mapped_; offset += page) {
+      static_cast<volatile char*>(data_)[offset] = 0;
+    }
+  }
+}
+
+template <size_t N, typename Stats>
+template <typename T>
+T* MmapStackStorage<N, Stats>::allocate(size_t n) {
+  void* result = data_ + shift_;
+  size_t left = N - shift_;
+  result = std::align(alignof(T), n * sizeof(T), result, left);
+  if (result == nullptr) {
+    stats_.on_failure(typeid(T), n * sizeof(T));
+    throw std::bad_alloc();
+  }
+  size_t padding = N - shift_ - left;
+  shift_ = reinterpret_cast<char*>(result) - data_ + n * sizeof(T);
+  stats_.on_allocation(typeid(T), n * sizeof(T), padding, shift_);
+  return reinterpret_cast<T*>(result);
+}
+
+template <size_t N, typename Stats>
+template <typename T>
+void MmapStackStorage<N, Stats>::deallocate(T* ptr, size_t n) {
+  char* begin = reinterpret_cast<char*>(ptr);
+  if (begin + n * sizeof(T) == data_ + shift_) {
+    shift_ = begin - data_;
+  }
+}
+
+template <typename T, size_t N>
+using MmapStackAllocator = ArenaAllocator<T, MmapStackStorage<N>>;
@@ -0,0 +1,122 @@
+#include <sys/resource.h>
+
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <new>
+#include <string>
+
+#include "mmap_storage.h"
+#include "stackallocator.h"
+
+#ifndef NO_TEST
+
+// NOLINTBEGIN
+
+void TestStorage() {
+    MmapStackStorage<1 << 20> storage(PageOptions{.prefault = false});
+    char* bytes = storage.allocate<char>(3);
+    double* doubles = storage.allocate<double>(4);
+    assert(reinterpret_cast<uintptr_t>(doubles) % alignof(double) == 0);
+    assert(static_cast<void*>(doubles) > static_cast<void*>(bytes));
+    size_t used = storage.used();
+    storage.deallocate(storage.allocate<int>(10), 10);
+    assert(storage.used() == used);
+    {
+        ArenaScope<MmapStackStorage<1 << 20>> scope(storage);
+        storage.allocate<char>(1000);
+    }
+    assert(storage.used() == used);
+
+    bool thrown = false;
+    try {
+        storage.allocate<char>(2 << 20);
+    } catch (const std::bad_alloc&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    MmapStackStorage<64 << 20> huge(PageOptions{.prefault = true, .huge_pages = true});
+    List<std::string, MmapStackAllocator<std::string, 64 << 20>> lst{
+            MmapStackAllocator<std::string, 64 << 20>(huge)};
+    for (int i = 0; i < 10'000; ++i) {
+        lst.push_back(std::to_string(i));
+    }
+    assert(lst.size() == 10'000 && *lst.rbegin() == "9999");
+    assert(huge.used() >= 10'000 * sizeof(std::string));
+}
+
+constexpr size_t BENCH_STORAGE = 256'000'000;
+
+long MinorFaults() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_minflt;
+}
+
+struct FirstPass {
+    long long setup_ms;
+    long long build_ms;
+    long faults;
+    bool huge_pages;
+};
+
+FirstPass BuildFirstPass(PageOptions options) {
+    using namespace std::chrono;
+    using Alloc = MmapStackAllocator<long long, BENCH_STORAGE>;
+
+    auto start = high_resolution_clock::now();
+    MmapStackStorage<BENCH_STORAGE> storage(options);
+    auto mapped = high_resolution_clock::now();
+    long faults = MinorFaults();
+    {
+        List<long long, Alloc> lst{Alloc(storage)};
+        for (int i = 0; i < 5'000'000; ++i) {
+            lst.push_back(i);
+        }
+        assert(*lst.rbegin() == 4'999'999);
+        faults = MinorFaults() - faults;
+    }
+    auto built = high_resolution_clock::now();
+    return {duration_cast<milliseconds>(mapped - start).count(), duration_cast<milliseconds>(built - mapped).count(),
+            faults, storage.huge_pages()};
+}
+
+void CompareFirstPass() {
+    FirstPass lazy = BuildFirstPass(PageOptions{.prefault = false});
+    FirstPass prefaulted = BuildFirstPass(PageOptions{.prefault = true});
+    FirstPass huge = BuildFirstPass(PageOptions{.prefault = true, .huge_pages = true});
+
+    // the build itself may still fault on the stack or the heap, but not on the arena
+    assert(prefaulted.faults * 10 < lazy.faults);
+    assert(huge.faults * 10 < lazy.faults);
+
+    auto print = [](const char* name, const FirstPass& pass) {
+        std::cerr << "  " << name << ": setup " << pass.setup_ms << " ms, 5M push_back " << pass.build_ms << " ms, "
+                  << pass.faults << " page faults" << std::endl;
+    };
+    print("lazy", lazy);
+    print("MAP_POPULATE", prefaulted);
+    print(huge.huge_pages ? "huge pages + prefault" : "prefault (huge page advice refused)", huge);
+}
+
+int main() {
+    TestStorage();
+    std::cerr << "Test 1 (mapped StackStorage with List) passed." << std::endl;
+
+    CompareFirstPass();
+    std::cerr << "Test 2 (first-pass construction without page faults) passed." << std::endl;
+
+    std::cout << 0;
+}
+
+// NOLINTEND
+
+#else
+
+int main() {
+    std::cerr << "Tests are turned off!\n";
+}
+
+#endif
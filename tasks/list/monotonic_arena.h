@@ -0,0 +1,112 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+#include "arena_allocator.h"
+
+template <size_t N>
+class MonotonicArena {
+  static_assert(N > 0, "inline buffer must not be empty");
+
+ private:
+  struct alignas(std::max_align_t) Block {
+    Block* previous;
+    size_t capacity;
+  };
+
+  char data_[N];
+  char* buffer_ = data_;
+  size_t capacity_ = N;
+  size_t shift_ = 0;
+  Block* blocks_ = nullptr;
+  size_t block_count_ = 0;
+  size_t reserved_ = 0;
+
+  void grow(size_t bytes, size_t alignment);
+
+ public:
+  using partial_deallocation = std::true_type;
+
+  MonotonicArena() = default;
+  MonotonicArena(const MonotonicArena&) = delete;
+  MonotonicArena& operator=(const MonotonicArena&) = delete;
+  ~MonotonicArena() {
+    release();
+  }
+
+  template <typename T>
+  T* allocate(size_t n);
+  template <typename T>
+  void deallocate(T* ptr, size_t n);
+
+  void release();
+
+  size_t block_count() const {
+    return block_count_;
+  }
+
+  size_t bytes_reserved() const {
+    return N + reserved_;
+  }
+};
+
+template <size_t N>
+void MonotonicArena<N>::grow(size_t bytes, size_t alignment) {
+  size_t capacity = std::max(capacity_ * 2, bytes + alignment);
+  void* memory = ::operator new(sizeof(Block) + capacity);
+  Block* block = static_cast<Block*>(memory);
+  block->previous = blocks_;
+  block->capacity = capacity;
+  blocks_ = block;
+  ++block_count_;
+  reserved_ += capacity;
+  buffer_ = reinterpret_cast<char*>(block + 1);
+  capacity_ = capacity;
+  shift_ = 0;
+}
+
+template <size_t N>
+template <typename T>
+T* MonotonicArena<N>::allocate(size_t n) {
+  void* result = buffer_ + shift_;
+  size_t left = capacity_ - shift_;
+  result = std::align(alignof(T), n * sizeof(T), result, left);
+  if (result == nullptr) {
+    grow(n * sizeof(T), alignof(T));
+    result = buffer_;
+    left = capacity_;
+    result = std::align(alignof(T), n * sizeof(T), result, left);
+  }
+  shift_ = reinterpret_cast<char*>(result) - buffer_ + n * sizeof(T);
+  return reinterpret_cast<T*>(result);
+}
+
+template <size_t N>
+template <typename T>
+void MonotonicArena<N>::deallocate(T* ptr, size_t n) {
+  char* begin = reinterpret_cast<char*>(ptr);
+  if (begin + n * sizeof(T) == buffer_ + shift_) {
+    shift_ = begin - buffer_;
+  }
+}
+
+template <size_t N>
+void MonotonicArena<N>::release() {
+  while (blocks_ != nullptr) {
+    Block* previous = blocks_->previous;
+    ::operator delete(blocks_);
+    blocks_ = previous;
+  }
+  buffer_ = data_;
+  capacity_ = N;
+  shift_ = 0;
+  block_count_ = 0;
+  reserved_ = 0;
+}
+
+template <typename T, size_t N>
+using MonotonicAllocator = ArenaAllocator<T, MonotonicArena<N>>;
@@ -0,0 +1,88 @@
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+#include "monotonic_arena.h"
+#include "stackallocator.h"
+
+#ifndef NO_TEST
+
+// NOLINTBEGIN
+
+void TestInlineThenHeap() {
+    MonotonicArena<256> arena;
+    MonotonicAllocator<char, 256> charalloc(arena);
+    MonotonicAllocator<long double, 256> ldalloc(charalloc);
+
+    char* small = charalloc.allocate(100);
+    assert(arena.block_count() == 0);
+
+    // does not fit into the inline buffer anymore, but must not throw
+    long double* big = ldalloc.allocate(100);
+    assert(arena.block_count() == 1);
+    assert(reinterpret_cast<uintptr_t>(big) % alignof(long double) == 0);
+    assert((void*)big != (void*)small);
+
+    // geometric growth: one more block for a request larger than the current one
+    char* huge = charalloc.allocate(10'000);
+    assert(arena.block_count() == 2);
+    assert(arena.bytes_reserved() >= 256 + 100 * sizeof(long double) + 10'000);
+    charalloc.deallocate(huge, 10'000);
+
+    arena.release();
+    assert(arena.block_count() == 0);
+    assert(arena.bytes_reserved() == 256);
+    charalloc.allocate(256);
+    assert(arena.block_count() == 0);
+}
+
+void TestList() {
+    using namespace std::chrono;
+    using Alloc = MonotonicAllocator<std::string, 4096>;
+
+    MonotonicArena<4096> arena;
+    auto start = high_resolution_clock::now();
+    {
+        List<std::string, Alloc> lst{Alloc(arena)};
+        for (int i = 0; i < 100'000; ++i) {
+            lst.push_back(std::to_string(i));
+        }
+        assert(lst.size() == 100'000);
+        assert(*lst.rbegin() == "99999");
+
+        auto copy = lst;
+        assert(copy.size() == lst.size());
+        assert(*copy.begin() == "0");
+    }
+    auto finish = high_resolution_clock::now();
+
+    // geometric growth keeps the number of heap blocks logarithmic
+    assert(arena.block_count() > 0);
+    assert(arena.block_count() < 20);
+
+    std::cerr << " 200'000 List nodes in " << duration_cast<milliseconds>(finish - start).count()
+              << " ms using " << arena.block_count() << " heap blocks, "
+              << arena.bytes_reserved() << " bytes reserved" << std::endl;
+}
+
+int main() {
+    TestInlineThenHeap();
+    std::cerr << "Test 1 (inline buffer then heap blocks) passed." << std::endl;
+
+    TestList();
+    std::cerr << "Test 2 (List over MonotonicArena) passed." << std::endl;
+
+    std::cout << 0;
+}
+
+// NOLINTEND
+
+#else
+
+int main() {
+    std::cerr << "Tests are turned off!\n";
+}
+
+#endif
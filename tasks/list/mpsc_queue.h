@@ -0,0 +1,124 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <new>
+#include <optional>
+#include <utility>
+
+template <typename T, typename Allocator = std::allocator<T>>
+class MpscQueue {
+ private:
+  struct Node {
+    std::atomic<Node*> next = nullptr;
+    alignas(T) unsigned char buffer[sizeof(T)];
+
+    T* value() {
+      return std::launder(reinterpret_cast<T*>(buffer));
+    }
+  };
+  using NodeAllocator =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+  using node_allocator_traits = typename std::allocator_traits<NodeAllocator>;
+
+  [[no_unique_address]] NodeAllocator node_allocator_;
+  alignas(64) std::atomic<Node*> head_;
+  alignas(64) Node* tail_;
+
+  Node* make_node();
+  void free_node(Node* node);
+  void link(Node* node);
+
+ public:
+  MpscQueue(const Allocator& alloc);
+  MpscQueue()
+      : MpscQueue(Allocator()) {
+  }
+  MpscQueue(const MpscQueue&) = delete;
+  MpscQueue& operator=(const MpscQueue&) = delete;
+  ~MpscQueue();
+
+  void push(const T& value);
+  void push(T&& value);
+
+  template <typename... Args>
+  void emplace(Args&&... args);
+
+  std::optional<T> try_pop();
+
+  bool empty() const {
+    return tail_->next.load(std::memory_order_acquire) == nullptr;
+  }
+};
+
+template <typename T, typename Allocator>
+typename MpscQueue<T, Allocator>::Node* MpscQueue<T, Allocator>::make_node() {
+  Node* node = node_allocator_traits::allocate(node_allocator_, 1);
+  ::new (static_cast<void*>(node)) Node;
+  return node;
+}
+
+template <typename T, typename Allocator>
+void MpscQueue<T, Allocator>::free_node(Node* node) {
+  node->~Node();
+  node_allocator_traits::deallocate(node_allocator_, node, 1);
+}
+
+template <typename T, typename Allocator>
+void MpscQueue<T, Allocator>::link(Node* node) {
+  Node* previous = head_.exchange(node, std::memory_order_acq_rel);
+  previous->next.store(node, std::memory_order_release);
+}
+
+template <typename T, typename Allocator>
+MpscQueue<T, Allocator>::MpscQueue(const Allocator& alloc)
+    : node_allocator_(alloc) {
+  Node* stub = make_node();
+  head_.store(stub, std::memory_order_relaxed);
+  tail_ = stub;
+}
+
+template <typename T, typename Allocator>
+MpscQueue<T, Allocator>::~MpscQueue() {
+  while (try_pop()) {
+  }
+  free_node(tail_);
+}
+
+template <typename T, typename Allocator>
+void MpscQueue<T, Allocator>::push(const T& value) {
+  emplace(value);
+}
+
+template <typename T, typename Allocator>
+void MpscQueue<T, Allocator>::push(T&& value) {
+  emplace(std::move(value));
+}
+
+template <typename T, typename Allocator>
+template <typename... Args>
+void MpscQueue<T, Allocator>::emplace(Args&&... args) {
+  Node* node = make_node();
+  try {
+    node_allocator_traits::construct(node_allocator_, node->value(),
+                                     std::forward<Args>(args)...);
+  } catch (...) {
+    free_node(node);
+    throw;
+  }
+  link(node);
+}
+
+template <typename T, typename Allocator>
+std::optional<T> MpscQueue<T, Allocator>::try_pop() {
+  Node* tail = tail_;
+  Node* next = tail->next.load(std::memory_order_acquire);
+  if (next == nullptr) {
+    return std::nullopt;
+  }
+  std::optional<T> result(std::move(*next->value()));
+  node_allocator_traits::destroy(node_allocator_, next->value());
+  tail_ = next;
+  free_node(tail);
+  return result;
+}
@@ -0,0 +1,143 @@
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "concurrent_storage.h"
+#include "mpsc_queue.h"
+#include "stackallocator.h"
+
+#ifndef NO_TEST
+
+// NOLINTBEGIN
+
+constexpr size_t STORAGE_SIZE = 200'000'000;
+ConcurrentStackStorage<STORAGE_SIZE> STATIC_STORAGE;
+
+struct Message {
+    int producer = 0;
+    int sequence = 0;
+};
+
+void TestSingleThread() {
+    MpscQueue<std::string> queue;
+    assert(queue.empty());
+    assert(!queue.try_pop());
+    queue.push("first");
+    std::string second = "second";
+    queue.push(second);
+    queue.emplace(3, 'x');
+    assert(!queue.empty());
+    assert(*queue.try_pop() == "first");
+    assert(*queue.try_pop() == "second");
+    assert(*queue.try_pop() == "xxx");
+    assert(queue.empty());
+
+    MpscQueue<std::unique_ptr<int>> owners;
+    owners.push(std::make_unique<int>(5));
+    owners.push(std::make_unique<int>(6));
+    assert(**owners.try_pop() == 5);
+}
+
+template <typename Queue>
+void RunProducers(Queue& queue, int producers, int per_producer) {
+    std::vector<int> next(producers, 0);
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&queue, p, per_producer] {
+            for (int i = 0; i < per_producer; ++i) {
+                queue.push(Message{p, i});
+            }
+        });
+    }
+    long long received = 0;
+    while (received < static_cast<long long>(producers) * per_producer) {
+        auto message = queue.try_pop();
+        if (!message) {
+            std::this_thread::yield();
+            continue;
+        }
+        assert(message->sequence == next[message->producer]);
+        ++next[message->producer];
+        ++received;
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    assert(!queue.try_pop());
+}
+
+class LockedList {
+ private:
+    std::mutex mutex_;
+    List<Message> list_;
+
+ public:
+    void push(const Message& message) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        list_.push_back(message);
+    }
+
+    std::optional<Message> try_pop() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (list_.size() == 0) {
+            return std::nullopt;
+        }
+        Message message = *list_.begin();
+        list_.pop_front();
+        return message;
+    }
+};
+
+void TestProducers() {
+    using namespace std::chrono;
+
+    const int producers = 4;
+    const int per_producer = 250'000;
+
+    auto start = high_resolution_clock::now();
+    {
+        MpscQueue<Message> queue;
+        RunProducers(queue, producers, per_producer);
+    }
+    auto lock_free = high_resolution_clock::now();
+    {
+        MpscQueue<Message, ConcurrentStackAllocator<Message, STORAGE_SIZE>> queue(STATIC_STORAGE);
+        RunProducers(queue, producers, per_producer);
+    }
+    auto arena = high_resolution_clock::now();
+    {
+        LockedList queue;
+        RunProducers(queue, producers, per_producer);
+    }
+    auto locked = high_resolution_clock::now();
+
+    std::cerr << " " << producers << " producers x " << per_producer << " messages: MpscQueue "
+              << duration_cast<milliseconds>(lock_free - start).count() << " ms, MpscQueue over ConcurrentStackStorage "
+              << duration_cast<milliseconds>(arena - lock_free).count() << " ms, mutex + List "
+              << duration_cast<milliseconds>(locked - arena).count() << " ms" << std::endl;
+}
+
+int main() {
+    TestSingleThread();
+    std::cerr << "Test 1 (single thread FIFO) passed." << std::endl;
+
+    TestProducers();
+    std::cerr << "Test 2 (per-producer order with concurrent producers) passed." << std::endl;
+
+    std::cout << 0;
+}
+
+// NOLINTEND
+
+#else
+
+int main() {
+    std::cerr << "Tests are turned off!\n";
+}
+
+#endif
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+#include "arena_allocator.h"
+#include "mmap_storage.h"
+#include "numa_topology.h"
+#include "stackstorage.h"
+
+// One arena per NUMA node, each bound to its node. Allocations go to the
+// arena of the node the calling thread is running on; deallocations go back
+// to whichever arena owns the pointer. Threads of one node share an arena,
+// so every call takes that node's lock.
+template <typename Arena>
+class NumaArenas {
+ private:
+  struct Slot {
+    std::mutex mutex;
+    std::unique_ptr<Arena> arena;
+  };
+
+  NumaTopology topology_;
+  std::vector<std::unique_ptr<Slot>> slots_;
+
+  Slot& owner(const void* ptr);
+
+ public:
+  using partial_deallocation = allows_partial_deallocation<Arena>;
+
+  explicit NumaArenas(PageOptions options = PageOptions(),
+                      const NumaTopology& topology = NumaTopology::host());
+  NumaArenas(const NumaArenas&) = delete;
+  NumaArenas& operator=(const NumaArenas&) = delete;
+
+  template <typename T>
+  T* allocate(size_t n) {
+    Slot& slot = *slots_[topology_.current_node()];
+    std::lock_guard<std::mutex> lock(slot.mutex);
+    return slot.arena->template allocate<T>(n);
+  }
+
+  template <typename T>
+  void deallocate(T* ptr, size_t n) {
+    Slot& slot = owner(ptr);
+    std::lock_guard<std::mutex> lock(slot.mutex);
+    slot.arena->deallocate(ptr, n);
+  }
+
+  // not synchronized: only for inspection while no thread allocates
+  const Arena& arena(int node) const {
+    return *slots_[node]->arena;
+  }
+
+  size_t size() const {
+    return topology_.nodes().size();
+  }
+};
+
+template <typename Arena>
+NumaArenas<Arena>::NumaArenas(PageOptions options,
+                              const NumaTopology& topology)
+    : topology_(topology),
+      slots_(topology.node_limit()) {
+  for (int node : topology_.nodes()) {
+    slots_[node].reset(new Slot);
+    options.numa_node = node;
+    slots_[node]->arena.reset(new Arena(options));
+  }
+}
+
+template <typename Arena>
+typename NumaArenas<Arena>::Slot& NumaArenas<Arena>::owner(const void* ptr) {
+  Slot& local = *slots_[topology_.current_node()];
+  if (local.arena->owns(ptr)) {
+    return local;
+  }
+  for (int node : topology_.nodes()) {
+    if (slots_[node]->arena->owns(ptr)) {
+      return *slots_[node];
+    }
+  }
+  return local;
+}
+
+template <typename T, size_t N>
+using NumaStackAllocator = ArenaAllocator<T, NumaArenas<MmapStackStorage<N>>>;
@@ -0,0 +1,179 @@
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "numa_storage.h"
+#include "stackallocator.h"
+
+#ifndef NO_TEST
+
+// NOLINTBEGIN
+
+constexpr size_t ARENA_SIZE = 64 << 20;
+
+// node the page holding ptr was placed on, or -1 if the kernel will not say
+int NodeOfPage(const void* ptr) {
+#ifdef SYS_get_mempolicy
+    const unsigned long mpol_f_node = 1;
+    const unsigned long mpol_f_addr = 2;
+    int node = -1;
+    if (syscall(SYS_get_mempolicy, &node, nullptr, 0, ptr, mpol_f_node | mpol_f_addr) == 0) {
+        return node;
+    }
+#endif
+    return -1;
+}
+
+void TestTopology() {
+    assert((parse_id_list("0-3,8,10-11") == std::vector<int>{0, 1, 2, 3, 8, 10, 11}));
+    assert((parse_id_list("5") == std::vector<int>{5}));
+    assert(parse_id_list("").empty());
+
+    const NumaTopology& host = NumaTopology::host();
+    assert(!host.nodes().empty());
+    const auto& nodes = host.nodes();
+    assert(std::find(nodes.begin(), nodes.end(), host.current_node()) != nodes.end());
+    assert(host.node_of_cpu(-1) == nodes.front());
+
+    NumaTopology fake({0, 1}, {0, 0, 1, 1});
+    assert(fake.node_limit() == 2 && fake.node_of_cpu(3) == 1 && fake.node_of_cpu(100) == 0);
+
+    std::cerr << "  host has " << nodes.size() << " NUMA node(s), this thread runs on node "
+              << host.current_node() << std::endl;
+}
+
+void TestBinding() {
+    int node = NumaTopology::host().nodes().front();
+    MmapStackStorage<1 << 20> bound(PageOptions{.prefault = true, .numa_node = node});
+    assert(bound.numa_node() == node || bound.numa_node() == -1);
+    int* values = bound.allocate<int>(1'000);
+    std::fill(values, values + 1'000, 7);
+    if (bound.numa_node() == node) {
+        int placed = NodeOfPage(values);
+        assert(placed == node || placed == -1);
+    }
+    assert(bound.owns(values) && bound.owns(values + 999));
+    int outside = 0;
+    assert(!bound.owns(&outside));
+
+    // a node that does not exist: the binding fails, the storage still works
+    MmapStackStorage<1 << 20> unbound(PageOptions{.prefault = true, .numa_node = 1000});
+    assert(unbound.numa_node() == -1);
+    List<int, MmapStackAllocator<int, 1 << 20>> lst{MmapStackAllocator<int, 1 << 20>(unbound)};
+    for (int i = 0; i < 1'000; ++i) {
+        lst.push_back(i);
+    }
+    assert(lst.size() == 1'000 && *lst.rbegin() == 999);
+
+    MmapStackStorage<1 << 20> plain(PageOptions{.prefault = false});
+    assert(plain.numa_node() == -1);
+}
+
+void TestRegistry() {
+    using Arenas = NumaArenas<MmapStackStorage<ARENA_SIZE>>;
+    using Alloc = NumaStackAllocator<long long, ARENA_SIZE>;
+
+    Arenas arenas(PageOptions{.prefault = false});
+    assert(arenas.size() == NumaTopology::host().nodes().size());
+
+    // lists are built on worker threads and torn down on this one
+    const int threads = 4;
+    std::vector<std::unique_ptr<List<long long, Alloc>>> lists;
+    for (int t = 0; t < threads; ++t) {
+        lists.emplace_back(new List<long long, Alloc>(Alloc(arenas)));
+    }
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&lists, t] {
+            for (int i = 0; i < 100'000; ++i) {
+                lists[t]->push_back(static_cast<long long>(t) * 1'000'000 + i);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    size_t used = 0;
+    for (int node : NumaTopology::host().nodes()) {
+        used += arenas.arena(node).used();
+    }
+    assert(used >= threads * 100'000 * sizeof(long long));
+    for (int t = 0; t < threads; ++t) {
+        assert(lists[t]->size() == 100'000 && *lists[t]->rbegin() == t * 1'000'000 + 99'999);
+    }
+    lists.clear();
+
+    // two nodes on paper, every CPU on node 1: everything lands in the second
+    // arena, bound or not depending on whether the host has that node
+    NumaArenas<MmapStackStorage<1 << 20>> fake(PageOptions{.prefault = false},
+                                               NumaTopology({0, 1}, std::vector<int>(4096, 1)));
+    assert(fake.size() == 2);
+    int* block = fake.allocate<int>(10);
+    assert(fake.arena(1).owns(block) && fake.arena(0).used() == 0);
+    assert(fake.arena(1).numa_node() == 1 || fake.arena(1).numa_node() == -1);
+    fake.deallocate(block, 10);
+    assert(fake.arena(1).used() == 0);
+}
+
+template <typename Alloc>
+long long BuildOnThreads(int threads, const Alloc& alloc) {
+    using namespace std::chrono;
+    auto start = high_resolution_clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            List<long long, Alloc> lst{alloc};
+            for (int i = 0; i < 1'000'000; ++i) {
+                lst.push_back(i);
+            }
+            assert(*lst.rbegin() == 999'999);
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+}
+
+void CompareWithMalloc() {
+    const int threads = 4;
+    NumaArenas<MmapStackStorage<size_t(256) << 20>> arenas;
+    long long malloc_ms = BuildOnThreads(threads, std::allocator<long long>());
+    long long numa_ms = BuildOnThreads(threads, NumaStackAllocator<long long, size_t(256) << 20>(arenas));
+    std::cerr << "  " << threads << " threads x 1M push_back: std::allocator " << malloc_ms
+              << " ms, NumaStackAllocator " << numa_ms << " ms" << std::endl;
+}
+
+int main() {
+    TestTopology();
+    std::cerr << "Test 1 (topology from sysfs) passed." << std::endl;
+
+    TestBinding();
+    std::cerr << "Test 2 (binding a mapping to a node) passed." << std::endl;
+
+    TestRegistry();
+    std::cerr << "Test 3 (per-node arenas keyed by CPU) passed." << std::endl;
+
+    CompareWithMalloc();
+    std::cerr << "Test 4 (comparison with malloc) passed." << std::endl;
+
+    std::cout << 0;
+}
+
+// NOLINTEND
+
+#else
+
+int main() {
+    std::cerr << "Tests are turned off!\n";
+}
+
+#endif
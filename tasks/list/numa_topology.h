@@ -0,0 +1,128 @@
+#pragma once
+
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Parses a kernel id list such as "0-3,8,10-11".
+inline std::vector<int> parse_id_list(const std::string& list) {
+  std::vector<int> ids;
+  std::istringstream in(list);
+  std::string range;
+  while (std::getline(in, range, ',')) {
+    size_t dash = range.find('-');
+    try {
+      int first = std::stoi(range.substr(0, dash));
+      int last = dash == std::string::npos ? first
+                                           : std::stoi(range.substr(dash + 1));
+      for (int id = first; id <= last; ++id) {
+        ids.push_back(id);
+      }
+    } catch (const std::exception&) {
+      // blank or malformed entries are skipped
+    }
+  }
+  return ids;
+}
+
+// Nodes and the CPU to node map as sysfs reports them. Hosts without the
+// files, or with NUMA disabled, look like a single node 0 owning every CPU.
+class NumaTopology {
+ private:
+  std::vector<int> nodes_;
+  std::vector<int> cpu_nodes_;
+
+  static std::string read_line(const std::string& path) {
+    std::ifstream in(path);
+    std::string line;
+    std::getline(in, line);
+    return line;
+  }
+
+  NumaTopology();
+
+ public:
+  // a made-up layout, e.g. to exercise multi-node code on a single-node host
+  NumaTopology(std::vector<int> nodes, std::vector<int> cpu_nodes)
+      : nodes_(std::move(nodes)),
+        cpu_nodes_(std::move(cpu_nodes)) {
+  }
+
+  static const NumaTopology& host() {
+    static const NumaTopology topology;
+    return topology;
+  }
+
+  const std::vector<int>& nodes() const {
+    return nodes_;
+  }
+
+  // one past the highest node id
+  size_t node_limit() const {
+    return static_cast<size_t>(nodes_.back()) + 1;
+  }
+
+  int node_of_cpu(int cpu) const {
+    if (cpu < 0 || static_cast<size_t>(cpu) >= cpu_nodes_.size()) {
+      return nodes_.front();
+    }
+    return cpu_nodes_[cpu];
+  }
+
+  // node of the CPU the calling thread runs on right now
+  int current_node() const {
+    return node_of_cpu(sched_getcpu());
+  }
+};
+
+inline NumaTopology::NumaTopology() {
+  nodes_ = parse_id_list(read_line("/sys/devices/system/node/online"));
+  if (nodes_.empty()) {
+    nodes_.push_back(0);
+  }
+  for (int node : nodes_) {
+    std::string path = "/sys/devices/system/node/node" +
+                       std::to_string(node) + "/cpulist";
+    for (int cpu : parse_id_list(read_line(path))) {
+      if (static_cast<size_t>(cpu) >= cpu_nodes_.size()) {
+        cpu_nodes_.resize(cpu + 1, nodes_.front());
+      }
+      cpu_nodes_[cpu] = node;
+    }
+  }
+}
+
+// Binds the pages of [memory, memory + bytes) to node with MPOL_BIND, so they
+// come from that node whichever thread touches them first. Must run before
+// the first touch. Returns false where the kernel refuses or lacks mbind,
+// e.g. inside a seccomp sandbox; the range then keeps first-touch placement.
+inline bool bind_to_numa_node(void* memory, size_t bytes, int node) {
+#ifdef SYS_mbind
+  const int mpol_bind = 2;
+  const size_t bits = 64;
+  // the kernel reads the mask as an array of unsigned long
+  // NOLINTNEXTLINE(google-runtime-int)
+  static_assert(sizeof(unsigned long) == sizeof(uint64_t));
+  if (node < 0) {
+    return false;
+  }
+  std::vector<uint64_t> mask(static_cast<size_t>(node) / bits + 1);
+  mask[node / bits] |= uint64_t{1} << (node % bits);
+  return syscall(SYS_mbind, memory, bytes, mpol_bind, mask.data(),
+                 mask.size() * bits + 1, 0) == 0;
+#else
+  static_cast<void>(memory);
+  static_cast<void>(bytes);
+  static_cast<void>(node);
+  return false;
+#endif
+}
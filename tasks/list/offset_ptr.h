@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+
+// Stores the distance from its own address to the target, so a structure of
+// OffsetPtr links stays valid when the whole region is mapped elsewhere.
+template <typename T>
+class OffsetPtr {
+ private:
+  // 0 would be a pointer to the OffsetPtr itself, which list sentinels need
+  static const ptrdiff_t null_offset = 1;
+
+  ptrdiff_t offset_ = null_offset;
+
+  using reference_type = std::add_lvalue_reference_t<
+      std::conditional_t<std::is_void_v<T>, char, T>>;
+
+  void set(const volatile void* target) {
+    offset_ = target == nullptr
+                  ? null_offset
+                  : reinterpret_cast<intptr_t>(target) -
+                        reinterpret_cast<intptr_t>(this);
+  }
+
+ public:
+  using element_type = T;
+  using value_type = std::remove_cv_t<T>;
+  using difference_type = ptrdiff_t;
+  using pointer = T*;
+  using reference = std::add_lvalue_reference_t<T>;
+  using iterator_category = std::random_access_iterator_tag;
+
+  template <typename U>
+  using rebind = OffsetPtr<U>;
+
+  OffsetPtr() = default;
+  OffsetPtr(std::nullptr_t) {
+  }
+  OffsetPtr(T* target) {
+    set(target);
+  }
+  OffsetPtr(const OffsetPtr& other) {
+    set(other.get());
+  }
+  template <typename U>
+    requires std::is_convertible_v<U*, T*>
+  OffsetPtr(const OffsetPtr<U>& other) {
+    set(static_cast<T*>(other.get()));
+  }
+  template <typename U>
+    requires(!std::is_convertible_v<U*, T*>)
+  explicit OffsetPtr(const OffsetPtr<U>& other) {
+    set(static_cast<T*>(other.get()));
+  }
+
+  OffsetPtr& operator=(const OffsetPtr& other) {
+    set(other.get());
+    return *this;
+  }
+  OffsetPtr& operator=(T* target) {
+    set(target);
+    return *this;
+  }
+
+  T* get() const {
+    if (offset_ == null_offset) {
+      return nullptr;
+    }
+    return reinterpret_cast<T*>(reinterpret_cast<intptr_t>(this) + offset_);
+  }
+
+  operator T*() const {
+    return get();
+  }
+
+  T* operator->() const {
+    return get();
+  }
+
+  reference operator*() const
+    requires(!std::is_void_v<T>)
+  {
+    return *get();
+  }
+
+  static OffsetPtr pointer_to(reference_type target) {
+    return OffsetPtr(&target);
+  }
+
+  OffsetPtr& operator++() {
+    offset_ += sizeof(T);
+    return *this;
+  }
+  OffsetPtr& operator--() {
+    offset_ -= sizeof(T);
+    return *this;
+  }
+  OffsetPtr& operator+=(ptrdiff_t n) {
+    offset_ += n * static_cast<ptrdiff_t>(sizeof(T));
+    return *this;
+  }
+  OffsetPtr& operator-=(ptrdiff_t n) {
+    offset_ -= n * static_cast<ptrdiff_t>(sizeof(T));
+    return *this;
+  }
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+
+#include "arena_allocator.h"
+#include "stackstorage.h"
+
+template <size_t N>
+class PoolStorage {
+ private:
+  struct alignas(std::max_align_t) Granule {
+    char bytes[alignof(std::max_align_t)];
+  };
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+  static const size_t granularity = sizeof(Granule);
+  static const size_t class_count = 16;
+
+  StackStorage<N> storage_;
+  FreeBlock* free_lists_[class_count] = {};
+
+  template <typename T>
+  static bool pooled(size_t n) {
+    return alignof(T) <= granularity &&
+           n * sizeof(T) <= class_count * granularity;
+  }
+
+  static size_t size_class(size_t bytes) {
+    return bytes == 0 ? 0 : (bytes - 1) / granularity;
+  }
+
+ public:
+  PoolStorage() = default;
+  PoolStorage(const PoolStorage&) = delete;
+  PoolStorage& operator=(const PoolStorage&) = delete;
+
+  template <typename T>
+  T* allocate(size_t n);
+  template <typename T>
+  void deallocate(T* ptr, size_t n);
+
+  size_t used() const {
+    return storage_.used();
+  }
+};
+
+template <size_t N>
+template <typename T>
+T* PoolStorage<N>::allocate(size_t n) {
+  if (!pooled<T>(n)) {
+    return storage_.template allocate<T>(n);
+  }
+  size_t index = size_class(n * sizeof(T));
+  FreeBlock* block = free_lists_[index];
+  if (block == nullptr) {
+    return reinterpret_cast<T*>(
+        storage_.template allocate<Granule>(index + 1));
+  }
+  free_lists_[index] = block->next;
+  return reinterpret_cast<T*>(block);
+}
+
+template <size_t N>
+template <typename T>
+void PoolStorage<N>::deallocate(T* ptr, size_t n) {
+  if (!pooled<T>(n)) {
+    storage_.deallocate(ptr, n);
+    return;
+  }
+  size_t index = size_class(n * sizeof(T));
+  FreeBlock* block = reinterpret_cast<FreeBlock*>(ptr);
+  block->next = free_lists_[index];
+  free_lists_[index] = block;
+}
+
+template <typename T, size_t N>
+using PoolAllocator = ArenaAllocator<T, PoolStorage<N>>;
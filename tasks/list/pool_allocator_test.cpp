@@ -0,0 +1,110 @@
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "pool_allocator.h"
+#include "stackallocator.h"
+
+#ifndef NO_TEST
+
+// NOLINTBEGIN
+
+constexpr size_t POOL_SIZE = 1'000'000;
+PoolStorage<POOL_SIZE> STATIC_POOL;
+
+void TestReuse() {
+    PoolStorage<10'000> pool;
+    PoolAllocator<int, 10'000> intalloc(pool);
+    PoolAllocator<double, 10'000> doublealloc(intalloc);
+
+    assert(intalloc == doublealloc);
+
+    int* a = intalloc.allocate(3);
+    size_t used = pool.used();
+    intalloc.deallocate(a, 3);
+
+    // 12 and 16 bytes share a size class
+    double* b = doublealloc.allocate(2);
+    assert((void*)b == (void*)a);
+    assert(pool.used() == used);
+    assert(reinterpret_cast<uintptr_t>(b) % alignof(double) == 0);
+    doublealloc.deallocate(b, 2);
+
+    // blocks larger than the biggest class bypass the free lists
+    char* big = PoolAllocator<char, 10'000>(pool).allocate(1000);
+    assert(pool.used() >= used + 1000);
+    PoolAllocator<char, 10'000>(pool).deallocate(big, 1000);
+    assert(pool.used() == used);
+}
+
+template <typename Alloc>
+int RandomChurn(Alloc alloc, size_t& checksum) {
+    using namespace std::chrono;
+    using ListType = List<int, Alloc>;
+
+    std::mt19937 gen(17);
+    ListType lst(alloc);
+    std::vector<typename ListType::const_iterator> live;
+
+    auto start = high_resolution_clock::now();
+    for (int i = 0; i < 2'000'000; ++i) {
+        if (live.size() < 1'000 || gen() % 2 == 0) {
+            auto where = live.empty() ? lst.cend() : live[gen() % live.size()];
+            lst.insert(where, i);
+            auto inserted = where;
+            --inserted;
+            live.push_back(inserted);
+        } else {
+            size_t index = gen() % live.size();
+            checksum += *live[index];
+            lst.erase(live[index]);
+            live[index] = live.back();
+            live.pop_back();
+        }
+    }
+    for (int x : lst) {
+        checksum += x;
+    }
+    auto finish = high_resolution_clock::now();
+    return duration_cast<milliseconds>(finish - start).count();
+}
+
+void TestListChurn() {
+    PoolStorage<POOL_SIZE>& pool = STATIC_POOL;
+    size_t pool_checksum = 0;
+    size_t std_checksum = 0;
+
+    int pool_time = RandomChurn(PoolAllocator<int, POOL_SIZE>(pool), pool_checksum);
+    int std_time = RandomChurn(std::allocator<int>(), std_checksum);
+
+    assert(pool_checksum == std_checksum);
+    // about a million nodes were inserted, but only a few thousand are alive at once
+    assert(pool.used() < POOL_SIZE / 4);
+
+    std::cerr << " Random insert/erase: std::allocator " << std_time << " ms, PoolAllocator "
+              << pool_time << " ms, pool usage " << pool.used() << " bytes" << std::endl;
+}
+
+int main() {
+    TestReuse();
+    std::cerr << "Test 1 (free list reuse) passed." << std::endl;
+
+    TestListChurn();
+    std::cerr << "Test 2 (List churn) passed." << std::endl;
+
+    std::cout << 0;
+}
+
+// NOLINTEND
+
+#else
+
+int main() {
+    std::cerr << "Tests are turned off!\n";
+}
+
+#endif
@@ -0,0 +1,422 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include "arena_allocator.h"
+
+// Size-class slab allocator for small objects. Each thread keeps a short free
+// list per class and trades blocks with the shared slabs in batches; a slab
+// that becomes empty goes back to the system once a class holds enough spares.
+// A thread's caches are handed back to every arena still alive when it exits.
+class SlabArena {
+ private:
+  static const size_t granularity = 16;
+  static const size_t class_count = 16;
+  static const size_t slab_size = size_t(64) << 10;
+  static const size_t batch = 32;
+  static const size_t retained_empty = 2;
+
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+  struct alignas(64) Slab {
+    Slab* next;
+    Slab* previous;
+    FreeBlock* free;
+    char* bump;
+    size_t live;
+    size_t size_class;
+  };
+  // slabs with free blocks come first, full ones are kept at the back
+  struct alignas(64) SizeClass {
+    std::mutex mutex;
+    Slab* head = nullptr;
+    Slab* tail = nullptr;
+    size_t empty = 0;
+  };
+  struct LocalCache {
+    FreeBlock* blocks[class_count] = {};
+    size_t counts[class_count] = {};
+  };
+  // ids tell a live arena from a dead one that left an entry behind at the
+  // same address
+  struct CacheEntry {
+    size_t registry;
+    SlabArena* arena;
+    LocalCache* cache;
+  };
+  // the calling thread's caches; its destructor flushes them at thread exit
+  struct ThreadCaches {
+    std::vector<CacheEntry> entries;
+    ~ThreadCaches();
+  };
+
+  static ThreadCaches& thread_caches() {
+    thread_local ThreadCaches caches;
+    return caches;
+  }
+
+  // set once thread_caches() is destroyed, for blocks freed even later by
+  // other thread_local or static objects
+  static bool& thread_exited() {
+    thread_local bool exited = false;
+    return exited;
+  }
+
+  // guards live_arenas() and the caches_ of every arena
+  static std::mutex& registry_mutex() {
+    static std::mutex mutex;
+    return mutex;
+  }
+
+  static std::vector<SlabArena*>& live_arenas() {
+    static std::vector<SlabArena*> arenas;
+    return arenas;
+  }
+
+  static size_t next_id() {
+    static std::atomic<size_t> counter = 0;
+    return ++counter;
+  }
+
+  static bool is_live(const CacheEntry& entry);
+
+  size_t id_ = next_id();
+  SizeClass classes_[class_count];
+  std::vector<std::unique_ptr<LocalCache>> caches_;
+  std::atomic<size_t> slab_count_ = 0;
+
+  static size_t block_size(size_t size_class) {
+    return (size_class + 1) * granularity;
+  }
+
+  static Slab* slab_of(void* block) {
+    return reinterpret_cast<Slab*>(reinterpret_cast<uintptr_t>(block) &
+                                   ~(slab_size - 1));
+  }
+
+  static bool has_space(const Slab* slab) {
+    return slab->free != nullptr ||
+           slab->bump + block_size(slab->size_class) <=
+               reinterpret_cast<const char*>(slab) + slab_size;
+  }
+
+  static void unlink(SizeClass& size_class, Slab* slab);
+  static void push_front(SizeClass& size_class, Slab* slab);
+  static void push_back(SizeClass& size_class, Slab* slab);
+
+  LocalCache* local();
+  LocalCache& register_thread();
+  void retire(LocalCache* cache);
+
+  Slab* make_slab(size_t size_class);
+  void free_slab(Slab* slab);
+  void refill(LocalCache& cache, size_t size_class);
+  void flush(LocalCache& cache, size_t size_class, size_t keep);
+
+  void* allocate_bytes(size_t bytes, size_t alignment);
+  void deallocate_bytes(void* ptr, size_t bytes, size_t alignment);
+
+ public:
+  SlabArena();
+  SlabArena(const SlabArena&) = delete;
+  SlabArena& operator=(const SlabArena&) = delete;
+  ~SlabArena();
+
+  template <typename T>
+  T* allocate(size_t n) {
+    return static_cast<T*>(allocate_bytes(n * sizeof(T), alignof(T)));
+  }
+
+  template <typename T>
+  void deallocate(T* ptr, size_t n) {
+    deallocate_bytes(ptr, n * sizeof(T), alignof(T));
+  }
+
+  // hands the calling thread's cached blocks back to the shared slabs, e.g.
+  // before a thread that is done with the arena goes idle
+  void flush_local();
+
+  void release_empty_slabs();
+
+  size_t slab_count() const {
+    return slab_count_.load(std::memory_order_relaxed);
+  }
+
+  size_t bytes_reserved() const {
+    return slab_count() * slab_size;
+  }
+};
+
+inline void SlabArena::unlink(SizeClass& size_class, Slab* slab) {
+  if (slab->previous != nullptr) {
+    slab->previous->next = slab->next;
+  } else {
+    size_class.head = slab->next;
+  }
+  if (slab->next != nullptr) {
+    slab->next->previous = slab->previous;
+  } else {
+    size_class.tail = slab->previous;
+  }
+}
+
+inline void SlabArena::push_front(SizeClass& size_class, Slab* slab) {
+  slab->previous = nullptr;
+  slab->next = size_class.head;
+  if (size_class.head != nullptr) {
+    size_class.head->previous = slab;
+  } else {
+    size_class.tail = slab;
+  }
+  size_class.head = slab;
+}
+
+inline void SlabArena::push_back(SizeClass& size_class, Slab* slab) {
+  slab->next = nullptr;
+  slab->previous = size_class.tail;
+  if (size_class.tail != nullptr) {
+    size_class.tail->next = slab;
+  } else {
+    size_class.head = slab;
+  }
+  size_class.tail = slab;
+}
+
+inline bool SlabArena::is_live(const CacheEntry& entry) {
+  const std::vector<SlabArena*>& arenas = live_arenas();
+  return std::find(arenas.begin(), arenas.end(), entry.arena) !=
+             arenas.end() &&
+         entry.arena->id_ == entry.registry;
+}
+
+inline SlabArena::ThreadCaches::~ThreadCaches() {
+  std::lock_guard<std::mutex> lock(registry_mutex());
+  for (const CacheEntry& entry : entries) {
+    if (is_live(entry)) {
+      entry.arena->retire(entry.cache);
+    }
+  }
+  thread_exited() = true;
+}
+
+inline SlabArena::LocalCache* SlabArena::local() {
+  if (thread_exited()) {
+    return nullptr;
+  }
+  for (const CacheEntry& entry : thread_caches().entries) {
+    if (entry.registry == id_) {
+      return entry.cache;
+    }
+  }
+  return &register_thread();
+}
+
+inline SlabArena::LocalCache& SlabArena::register_thread() {
+  std::unique_ptr<LocalCache> cache(new LocalCache);
+  LocalCache* result = cache.get();
+  std::vector<CacheEntry>& entries = thread_caches().entries;
+  std::lock_guard<std::mutex> lock(registry_mutex());
+  // drop what arenas destroyed since this thread last registered left behind
+  std::erase_if(entries,
+                [](const CacheEntry& entry) { return !is_live(entry); });
+  caches_.push_back(std::move(cache));
+  entries.push_back({id_, this, result});
+  return *result;
+}
+
+// registry_mutex() is held by the caller
+inline void SlabArena::retire(LocalCache* cache) {
+  for (size_t size_class = 0; size_class < class_count; ++size_class) {
+    if (cache->counts[size_class] > 0) {
+      flush(*cache, size_class, 0);
+    }
+  }
+  for (auto& owned : caches_) {
+    if (owned.get() == cache) {
+      owned = std::move(caches_.back());
+      caches_.pop_back();
+      break;
+    }
+  }
+}
+
+inline SlabArena::Slab* SlabArena::make_slab(size_t size_class) {
+  void* memory = ::operator new(slab_size, std::align_val_t(slab_size));
+  Slab* slab = ::new (memory) Slab;
+  slab->next = nullptr;
+  slab->previous = nullptr;
+  slab->free = nullptr;
+  slab->bump = static_cast<char*>(memory) + sizeof(Slab);
+  slab->live = 0;
+  slab->size_class = size_class;
+  slab_count_.fetch_add(1, std::memory_order_relaxed);
+  return slab;
+}
+
+inline void SlabArena::free_slab(Slab* slab) {
+  slab->~Slab();
+  ::operator delete(static_cast<void*>(slab), std::align_val_t(slab_size));
+  slab_count_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+inline void SlabArena::refill(LocalCache& cache, size_t size_class) {
+  SizeClass& shared = classes_[size_class];
+  std::lock_guard<std::mutex> lock(shared.mutex);
+  for (size_t i = 0; i < batch; ++i) {
+    Slab* slab = shared.head;
+    if (slab == nullptr || !has_space(slab)) {
+      slab = make_slab(size_class);
+      push_front(shared, slab);
+      ++shared.empty;
+    }
+    FreeBlock* block = slab->free;
+    if (block != nullptr) {
+      slab->free = block->next;
+    } else {
+      block = reinterpret_cast<FreeBlock*>(slab->bump);
+      slab->bump += block_size(size_class);
+    }
+    if (slab->live++ == 0) {
+      --shared.empty;
+    }
+    if (!has_space(slab)) {
+      unlink(shared, slab);
+      push_back(shared, slab);
+    }
+    block->next = cache.blocks[size_class];
+    cache.blocks[size_class] = block;
+    ++cache.counts[size_class];
+  }
+}
+
+inline void SlabArena::flush(LocalCache& cache, size_t size_class,
+                             size_t keep) {
+  SizeClass& shared = classes_[size_class];
+  std::lock_guard<std::mutex> lock(shared.mutex);
+  while (cache.counts[size_class] > keep) {
+    FreeBlock* block = cache.blocks[size_class];
+    cache.blocks[size_class] = block->next;
+    --cache.counts[size_class];
+
+    Slab* slab = slab_of(block);
+    if (!has_space(slab)) {
+      unlink(shared, slab);
+      push_front(shared, slab);
+    }
+    block->next = slab->free;
+    slab->free = block;
+    if (--slab->live > 0) {
+      continue;
+    }
+    if (shared.empty < retained_empty) {
+      ++shared.empty;
+    } else {
+      unlink(shared, slab);
+      free_slab(slab);
+    }
+  }
+}
+
+inline void* SlabArena::allocate_bytes(size_t bytes, size_t alignment) {
+  if (bytes > class_count * granularity || alignment > granularity) {
+    return ::operator new(bytes, std::align_val_t(alignment));
+  }
+  size_t size_class = bytes == 0 ? 0 : (bytes - 1) / granularity;
+  LocalCache* cache = local();
+  LocalCache spare;
+  if (cache == nullptr) {
+    cache = &spare;
+  }
+  if (cache->blocks[size_class] == nullptr) {
+    refill(*cache, size_class);
+  }
+  FreeBlock* block = cache->blocks[size_class];
+  cache->blocks[size_class] = block->next;
+  --cache->counts[size_class];
+  if (cache == &spare) {
+    flush(spare, size_class, 0);
+  }
+  return block;
+}
+
+inline void SlabArena::deallocate_bytes(void* ptr, size_t bytes,
+                                        size_t alignment) {
+  if (bytes > class_count * granularity || alignment > granularity) {
+    ::operator delete(ptr, std::align_val_t(alignment));
+    return;
+  }
+  size_t size_class = bytes == 0 ? 0 : (bytes - 1) / granularity;
+  LocalCache* cache = local();
+  LocalCache spare;
+  if (cache == nullptr) {
+    cache = &spare;
+  }
+  FreeBlock* block = static_cast<FreeBlock*>(ptr);
+  block->next = cache->blocks[size_class];
+  cache->blocks[size_class] = block;
+  if (++cache->counts[size_class] > 2 * batch) {
+    flush(*cache, size_class, batch);
+  } else if (cache == &spare) {
+    flush(spare, size_class, 0);
+  }
+}
+
+inline void SlabArena::flush_local() {
+  LocalCache* cache = local();
+  if (cache == nullptr) {
+    return;
+  }
+  for (size_t size_class = 0; size_class < class_count; ++size_class) {
+    if (cache->counts[size_class] > 0) {
+      flush(*cache, size_class, 0);
+    }
+  }
+}
+
+inline void SlabArena::release_empty_slabs() {
+  for (SizeClass& shared : classes_) {
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    Slab* slab = shared.head;
+    while (slab != nullptr) {
+      Slab* next = slab->next;
+      if (slab->live == 0) {
+        unlink(shared, slab);
+        free_slab(slab);
+      }
+      slab = next;
+    }
+    shared.empty = 0;
+  }
+}
+
+inline SlabArena::SlabArena() {
+  std::lock_guard<std::mutex> lock(registry_mutex());
+  live_arenas().push_back(this);
+}
+
+inline SlabArena::~SlabArena() {
+  {
+    std::lock_guard<std::mutex> lock(registry_mutex());
+    std::vector<SlabArena*>& arenas = live_arenas();
+    arenas.erase(std::find(arenas.begin(), arenas.end(), this));
+    caches_.clear();
+  }
+  for (SizeClass& shared : classes_) {
+    while (shared.head != nullptr) {
+      Slab* slab = shared.head;
+      shared.head = slab->next;
+      free_slab(slab);
+    }
+  }
+}
+
+template <typename T>
+using SlabAllocator = ArenaAllocator<T, SlabArena>;
@@ -0,0 +1,225 @@
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../shared_ptr/smart_pointers.h"
+#include "../unordered_map/unordered_map.h"
+#include "slab_allocator.h"
+
+#ifndef NO_TEST
+
+// NOLINTBEGIN
+
+struct Sample {
+    long long a = 0;
+    long long b = 0;
+    Sample() = default;
+    Sample(long long a, long long b) : a(a), b(b) {}
+};
+
+void TestSlabs() {
+    SlabArena arena;
+    std::vector<std::pair<char*, size_t>> blocks;
+    for (size_t i = 0; i < 20'000; ++i) {
+        size_t size = 1 + i % 300;
+        char* block = arena.allocate<char>(size);
+        std::fill(block, block + size, static_cast<char>(i));
+        blocks.emplace_back(block, size);
+    }
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        auto [block, size] = blocks[i];
+        assert(block[0] == static_cast<char>(i) && block[size - 1] == static_cast<char>(i));
+    }
+    Sample* samples = arena.allocate<Sample>(3);
+    assert(reinterpret_cast<uintptr_t>(samples) % alignof(Sample) == 0);
+    arena.deallocate(samples, 3);
+    assert(arena.slab_count() > 0);
+
+    for (auto [block, size] : blocks) {
+        arena.deallocate(block, size);
+    }
+    arena.flush_local();
+    arena.release_empty_slabs();
+    assert(arena.slab_count() == 0);
+
+    // reuse after a release
+    int* value = arena.allocate<int>(1);
+    *value = 5;
+    arena.deallocate(value, 1);
+}
+
+void TestContainers() {
+    SlabArena arena;
+    using Pair = std::pair<const int, std::string>;
+    UnorderedMap<int, std::string, std::hash<int>, std::equal_to<int>, SlabAllocator<Pair>> m{
+            SlabAllocator<Pair>(arena)};
+    for (int i = 0; i < 10'000; ++i) {
+        m.emplace(i, std::to_string(i));
+    }
+    for (int i = 0; i < 10'000; i += 2) {
+        m.erase(m.find(i));
+    }
+    assert(m.size() == 5'000 && m.at(4'999) == "4999");
+
+    List<Sample, SlabAllocator<Sample>> lst{SlabAllocator<Sample>(arena)};
+    for (int i = 0; i < 10'000; ++i) {
+        lst.push_back(Sample(i, -i));
+    }
+    lst.pop_front();
+    assert(lst.size() == 9'999 && lst.begin()->a == 1);
+
+    std::vector<SharedPtr<Sample>> pointers;
+    for (int i = 0; i < 1'000; ++i) {
+        pointers.push_back(allocateShared<Sample>(SlabAllocator<Sample>(arena), i, i));
+    }
+    WeakPtr<Sample> weak = pointers[7];
+    assert(weak.lock()->a == 7);
+    pointers.clear();
+    assert(weak.expired());
+}
+
+void TestThreads() {
+    SlabArena arena;
+    const int threads = 4;
+    const int per_thread = 50'000;
+
+    // every thread frees the blocks allocated by its neighbour
+    std::vector<std::vector<Sample*>> allocated(threads);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&arena, &allocated, t] {
+            for (int i = 0; i < per_thread; ++i) {
+                allocated[t].push_back(::new (arena.allocate<Sample>(1)) Sample(t, i));
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&arena, &allocated, t] {
+            const auto& blocks = allocated[(t + 1) % threads];
+            for (int i = 0; i < per_thread; ++i) {
+                assert(blocks[i]->b == i);
+                arena.deallocate(blocks[i], 1);
+            }
+            arena.flush_local();
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    // the allocating threads handed their cached blocks back when they exited
+    arena.release_empty_slabs();
+    assert(arena.slab_count() == 0);
+
+    // a thread outlives an arena it used, then exits after using another one
+    auto first = std::make_unique<SlabArena>();
+    SlabArena second;
+    std::mutex mutex;
+    std::condition_variable changed;
+    int stage = 0;
+    std::thread worker([&] {
+        first->deallocate(first->allocate<Sample>(1), 1);
+        std::unique_lock<std::mutex> lock(mutex);
+        stage = 1;
+        changed.notify_all();
+        changed.wait(lock, [&] { return stage == 2; });
+        second.deallocate(second.allocate<Sample>(1), 1);
+    });
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [&] { return stage == 1; });
+        first.reset();
+        stage = 2;
+        changed.notify_all();
+    }
+    worker.join();
+    assert(second.slab_count() == 1);
+    second.release_empty_slabs();
+    assert(second.slab_count() == 0);
+}
+
+template <typename Alloc>
+void Workload(const Alloc& alloc, int rounds) {
+    using Pair = std::pair<const int, int>;
+    using MapAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<Pair>;
+    using ListAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<Sample>;
+
+    for (int round = 0; round < rounds; ++round) {
+        UnorderedMap<int, int, std::hash<int>, std::equal_to<int>, MapAlloc> m{MapAlloc(alloc)};
+        List<Sample, ListAlloc> lst{ListAlloc(alloc)};
+        std::vector<SharedPtr<Sample>> pointers;
+        for (int i = 0; i < 50'000; ++i) {
+            m.emplace(i, i);
+            lst.push_back(Sample(i, i));
+            pointers.push_back(allocateShared<Sample>(ListAlloc(alloc), i, i));
+            if (i % 3 == 0) {
+                lst.pop_front();
+                pointers[i / 3] = SharedPtr<Sample>();
+            }
+        }
+        for (int i = 0; i < 50'000; i += 2) {
+            m.erase(m.find(i));
+        }
+        assert(m.size() == 25'000);
+    }
+}
+
+template <typename Alloc>
+long long RunThreads(const Alloc& alloc, int threads, int rounds) {
+    using namespace std::chrono;
+    auto start = high_resolution_clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&alloc, rounds] { Workload(alloc, rounds); });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+}
+
+void CompareWithMalloc() {
+    SlabArena arena;
+    for (int threads : {1, 4}) {
+        long long malloc_time = RunThreads(std::allocator<Sample>(), threads, 10);
+        long long slab_time = RunThreads(SlabAllocator<Sample>(arena), threads, 10);
+        std::cerr << "  " << threads << " thread(s) x 10 rounds of map + list + allocateShared: malloc "
+                  << malloc_time << " ms, SlabAllocator " << slab_time << " ms" << std::endl;
+    }
+}
+
+int main() {
+    TestSlabs();
+    std::cerr << "Test 1 (size classes and returning empty slabs) passed." << std::endl;
+
+    TestContainers();
+    std::cerr << "Test 2 (UnorderedMap, List and allocateShared on slabs) passed." << std::endl;
+
+    TestThreads();
+    std::cerr << "Test 3 (cross-thread frees and thread exit) passed." << std::endl;
+
+    CompareWithMalloc();
+    std::cerr << "Test 4 (comparison with malloc) passed." << std::endl;
+
+    std::cout << 0;
+}
+
+// NOLINTEND
+
+#else
+
+int main() {
+    std::cerr << "Tests are turned off!\n";
+}
+
+#endif
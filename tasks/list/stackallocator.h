@@ -1,101 +1,29 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
 #include <memory>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
-template <size_t N>
-class StackStorage {
- private:
-  char data_[N];
-  size_t shift_ = 0;
-
- public:
-  StackStorage() = default;
-  StackStorage(const StackStorage&) = delete;
-  StackStorage& operator=(const StackStorage&) = delete;
-  template <typename T>
-  T* allocate(size_t n);
-};
-
-template <size_t N>
-template <typename T>
-T* StackStorage<N>::allocate(size_t n) {
-  void* result = data_ + shift_;
-  size_t left = N - shift_;
-  result = std::align(alignof(T), n * sizeof(T), result, left);
-  if (result == nullptr) {
-    throw std::bad_alloc();
-  }
-  shift_ = reinterpret_cast<char*>(result) - data_ + n * sizeof(T);
-  return reinterpret_cast<T*>(result);
-}
-
-template <typename T, size_t N>
-class StackAllocator {
- public:
-  StackStorage<N>* storage_;
-  using value_type = T;
-
-  StackAllocator() = delete;
-  StackAllocator(StackStorage<N>& storage)
-      : storage_(&storage) {
-  }
-  ~StackAllocator() {
-  }
-
-  template <typename U>
-  StackAllocator(const StackAllocator<U, N>& other);
-
-  template <typename U>
-  StackAllocator& operator=(const StackAllocator<U, N>& other);
-
-  size_t max_size() const {
-    return N / sizeof(T);
-  }
-
-  template <typename U>
-  struct rebind {
-    using other = StackAllocator<U, N>;
-  };
-
-  T* allocate(size_t n) {
-    return storage_->template allocate<T>(n);
-  }
-
-  void deallocate(T*, size_t) {
-  }
-
-  template <typename U, size_t M>
-  bool operator==(const StackAllocator<U, M>& other) const {
-    return storage_ == other.storage_;
-  }
-
-  template <typename U, size_t M>
-  bool operator!=(const StackAllocator<U, M>& other) const {
-    return !(*this == other);
-  }
-};
-
-template <typename T, size_t N>
-template <typename U>
-StackAllocator<T, N>::StackAllocator(const StackAllocator<U, N>& other) {
-  storage_ = other.storage_;
-}
-
-template <typename T, size_t N>
-template <typename U>
-StackAllocator<T, N>& StackAllocator<T, N>::operator=(
-    const StackAllocator<U, N>& other) {
-  storage_ = other.storage_;
-}
+#include "stackstorage.h"
 
 template <typename T, typename Allocator = std::allocator<T>>
 class List {
  private:
+  struct BaseNode;
+  // links use the allocator's pointer type, so fancy pointers such as
+  // OffsetPtr keep a list valid inside a relocatable region
+  using BasePointer = typename std::pointer_traits<
+      typename std::allocator_traits<Allocator>::pointer>::template rebind<
+      BaseNode>;
+
   struct BaseNode {
-    BaseNode* next;
-    BaseNode* previous;
+    BasePointer next;
+    BasePointer previous;
     BaseNode()
         : next(this),
           previous(this) {
@@ -103,11 +31,9 @@ class List {
   };
   struct Node : public BaseNode {
     T value;
-    Node(const T& val)
-        : value(val) {
-    }
-    Node()
-        : value() {
+    template <typename... Args>
+    Node(Args&&... args)
+        : value(std::forward<Args>(args)...) {
     }
   };
   using NodeAllocator =
@@ -117,10 +43,32 @@ class List {
   BaseNode end_;
   size_t size_ = 0;
 
+  static constexpr bool batch_nodes =
+      allows_partial_deallocation<NodeAllocator>::value;
+  static constexpr bool nothrow_move_assign =
+      node_allocator_traits::propagate_on_container_move_assignment::value ||
+      node_allocator_traits::is_always_equal::value;
+
   template <typename... Args>
   void make_list(size_t size, Args&&...);
 
+  template <typename Construct>
+  void append_nodes(size_t count, Construct construct);
+
+  void link_back(BaseNode* node);
+
   void repair_pointers();
+  void swap_nodes(List& other);
+
+  static void transfer(BaseNode* position, BaseNode* first, BaseNode* last);
+
+  template <typename Compare>
+  static BaseNode* merge_runs(BaseNode* first, BaseNode* second,
+                              Compare& compare);
+
+  static const T& value_of(const BaseNode* node) {
+    return static_cast<const Node*>(node)->value;
+  }
 
   template <bool is_constant>
   class base_iterator {
@@ -184,8 +132,14 @@ class List {
   }
   List(size_t size, const T& value);
   List(size_t size);
+  template <std::input_iterator InputIterator>
+  List(InputIterator first, InputIterator last, const Allocator& alloc);
+  template <std::input_iterator InputIterator>
+  List(InputIterator first, InputIterator last);
   List(const List<T, Allocator>& other);
+  List(List<T, Allocator>&& other) noexcept;
   List& operator=(const List<T, Allocator>& other);
+  List& operator=(List<T, Allocator>&& other) noexcept(nothrow_move_assign);
   ~List() {
     clear();
   }
@@ -201,7 +155,14 @@ class List {
   }
 
   void push_back(const T& value);
+  void push_back(T&& value);
   void push_front(const T& value);
+  void push_front(T&& value);
+
+  template <typename... Args>
+  void emplace_back(Args&&... args);
+  template <typename... Args>
+  void emplace_front(Args&&... args);
   void pop_back();
   void pop_front();
 
@@ -220,10 +181,32 @@ class List {
   const_reverse_iterator crend() const;
 
   void insert(const_iterator, const T&);
+  void insert(const_iterator, T&&);
   void erase(const_iterator);
 
   template <typename... Args>
   void emplace(const_iterator, Args&&...);
+
+  void splice(const_iterator, List& other);
+  void splice(const_iterator, List& other, const_iterator);
+  void splice(const_iterator, List& other, const_iterator, const_iterator);
+
+  void merge(List& other);
+  template <typename Compare>
+  void merge(List& other, Compare compare);
+
+  void sort();
+  template <typename Compare>
+  void sort(Compare compare);
+
+  void reverse();
+
+  void compact();
+  double fragmentation() const;
+
+  void unique();
+  template <typename BinaryPredicate>
+  void unique(BinaryPredicate predicate);
 };
 
 template <typename T, typename Allocator>
@@ -262,26 +245,87 @@ List<T, Allocator>::base_iterator<is_constant>::operator--(int) {
 
 template <typename T, typename Allocator>
 void List<T, Allocator>::clear() {
-  while (size_ > 0) {
-    pop_back();
+  BaseNode* node = end_.previous;
+  while (node != &end_) {
+    Node* first = static_cast<Node*>(node);
+    node = node->previous;
+    node_allocator_traits::destroy(node_allocator_, first);
+    size_t count = 1;
+    while (batch_nodes && node != &end_ &&
+           static_cast<Node*>(node) + 1 == first) {
+      first = static_cast<Node*>(node);
+      node = node->previous;
+      node_allocator_traits::destroy(node_allocator_, first);
+      ++count;
+    }
+    node_allocator_traits::deallocate(node_allocator_, first, count);
   }
+  end_.next = &end_;
+  end_.previous = &end_;
+  size_ = 0;
 }
 
 template <typename T, typename Allocator>
 template <typename... Args>
 void List<T, Allocator>::make_list(size_t size, Args&&... args) {
   try {
-    for (size_t i = 0; i < size; ++i) {
-      emplace(end(), args...);
-    }
+    append_nodes(size, [&](Node* node) {
+      node_allocator_traits::construct(node_allocator_, node, args...);
+    });
   } catch (...) {
     clear();
     throw;
   }
 }
 
+template <typename T, typename Allocator>
+void List<T, Allocator>::link_back(BaseNode* node) {
+  node->previous = end_.previous;
+  node->next = &end_;
+  end_.previous->next = node;
+  end_.previous = node;
+  ++size_;
+}
+
+template <typename T, typename Allocator>
+template <typename Construct>
+void List<T, Allocator>::append_nodes(size_t count, Construct construct) {
+  if (count == 0) {
+    return;
+  }
+  if constexpr (batch_nodes) {
+    Node* slab = node_allocator_traits::allocate(node_allocator_, count);
+    for (size_t i = 0; i < count; ++i) {
+      try {
+        construct(slab + i);
+      } catch (...) {
+        node_allocator_traits::deallocate(node_allocator_, slab + i,
+                                          count - i);
+        throw;
+      }
+      link_back(slab + i);
+    }
+  } else {
+    for (size_t i = 0; i < count; ++i) {
+      Node* node = node_allocator_traits::allocate(node_allocator_, 1);
+      try {
+        construct(node);
+      } catch (...) {
+        node_allocator_traits::deallocate(node_allocator_, node, 1);
+        throw;
+      }
+      link_back(node);
+    }
+  }
+}
+
 template <typename T, typename Allocator>
 void List<T, Allocator>::repair_pointers() {
+  if (size_ == 0) {
+    end_.next = &end_;
+    end_.previous = &end_;
+    return;
+  }
   end_.next->previous = &end_;
   end_.previous->next = &end_;
 }
@@ -292,8 +336,32 @@ List<T, Allocator>::List(const List<T, Allocator>& other)
           node_allocator_traits::select_on_container_copy_construction(
               other.node_allocator_)) {
   try {
-    for (auto& x : other) {
-      push_back(x);
+    const_iterator source = other.begin();
+    append_nodes(other.size_, [&](Node* node) {
+      node_allocator_traits::construct(node_allocator_, node, *source);
+      ++source;
+    });
+  } catch (...) {
+    clear();
+    throw;
+  }
+}
+
+template <typename T, typename Allocator>
+template <std::input_iterator InputIterator>
+List<T, Allocator>::List(InputIterator first, InputIterator last,
+                         const Allocator& alloc)
+    : node_allocator_(alloc) {
+  try {
+    if constexpr (std::forward_iterator<InputIterator>) {
+      append_nodes(std::distance(first, last), [&](Node* node) {
+        node_allocator_traits::construct(node_allocator_, node, *first);
+        ++first;
+      });
+    } else {
+      for (; first != last; ++first) {
+        push_back(*first);
+      }
     }
   } catch (...) {
     clear();
@@ -301,22 +369,72 @@ List<T, Allocator>::List(const List<T, Allocator>& other)
   }
 }
 
+template <typename T, typename Allocator>
+template <std::input_iterator InputIterator>
+List<T, Allocator>::List(InputIterator first, InputIterator last)
+    : List(first, last, Allocator()) {
+}
+
 template <typename T, typename Allocator>
 List<T, Allocator>& List<T, Allocator>::operator=(
     const List<T, Allocator>& other) {
-  List<T, Allocator> tmp(other);
-  if (node_allocator_traits::propagate_on_container_copy_assignment::value) {
-    tmp.node_allocator_ = other.node_allocator_;
-  }
-  std::swap(node_allocator_, tmp.node_allocator_);
-  std::swap(size_, tmp.size_);
-  std::swap(end_.previous, tmp.end_.previous);
-  std::swap(end_.next, tmp.end_.next);
-  repair_pointers();
-  tmp.repair_pointers();
+  constexpr bool propagate =
+      node_allocator_traits::propagate_on_container_copy_assignment::value;
+  List<T, Allocator> tmp(other.cbegin(), other.cend(),
+                         propagate ? other.get_allocator() : get_allocator());
+  clear();
+  if constexpr (propagate) {
+    node_allocator_ = other.node_allocator_;
+  }
+  swap_nodes(tmp);
+  return *this;
+}
+
+template <typename T, typename Allocator>
+List<T, Allocator>::List(List<T, Allocator>&& other) noexcept
+    : node_allocator_(std::move(other.node_allocator_)) {
+  swap_nodes(other);
+}
+
+template <typename T, typename Allocator>
+List<T, Allocator>& List<T, Allocator>::operator=(
+    List<T, Allocator>&& other) noexcept(nothrow_move_assign) {
+  if (&other == this) {
+    return *this;
+  }
+  if constexpr (node_allocator_traits::propagate_on_container_move_assignment::
+                    value) {
+    clear();
+    node_allocator_ = std::move(other.node_allocator_);
+    swap_nodes(other);
+  } else {
+    if (node_allocator_ == other.node_allocator_) {
+      clear();
+      swap_nodes(other);
+      return *this;
+    }
+    List<T, Allocator> tmp(get_allocator());
+    iterator source = other.begin();
+    tmp.append_nodes(other.size_, [&](Node* node) {
+      node_allocator_traits::construct(node_allocator_, node,
+                                       std::move(*source));
+      ++source;
+    });
+    swap_nodes(tmp);
+    other.clear();
+  }
   return *this;
 }
 
+template <typename T, typename Allocator>
+void List<T, Allocator>::swap_nodes(List& other) {
+  std::swap(size_, other.size_);
+  std::swap(end_.previous, other.end_.previous);
+  std::swap(end_.next, other.end_.next);
+  repair_pointers();
+  other.repair_pointers();
+}
+
 template <typename T, typename Allocator>
 List<T, Allocator>::List(size_t size, const T& value, const Allocator& alloc)
     : node_allocator_(alloc) {
@@ -344,11 +462,33 @@ void List<T, Allocator>::push_front(const T& value) {
   insert(begin(), value);
 }
 
+template <typename T, typename Allocator>
+void List<T, Allocator>::push_front(T&& value) {
+  insert(begin(), std::move(value));
+}
+
 template <typename T, typename Allocator>
 void List<T, Allocator>::push_back(const T& value) {
   insert(end(), value);
 }
 
+template <typename T, typename Allocator>
+void List<T, Allocator>::push_back(T&& value) {
+  insert(end(), std::move(value));
+}
+
+template <typename T, typename Allocator>
+template <typename... Args>
+void List<T, Allocator>::emplace_front(Args&&... args) {
+  emplace(begin(), std::forward<Args>(args)...);
+}
+
+template <typename T, typename Allocator>
+template <typename... Args>
+void List<T, Allocator>::emplace_back(Args&&... args) {
+  emplace(end(), std::forward<Args>(args)...);
+}
+
 template <typename T, typename Allocator>
 void List<T, Allocator>::pop_front() {
   erase(begin());
@@ -430,6 +570,11 @@ void List<T, Allocator>::insert(const_iterator iter, const T& value) {
   emplace(iter, value);
 }
 
+template <typename T, typename Allocator>
+void List<T, Allocator>::insert(const_iterator iter, T&& value) {
+  emplace(iter, std::move(value));
+}
+
 template <typename T, typename Allocator>
 void List<T, Allocator>::erase(const_iterator iter) {
   iter.node_->previous->next = iter.node_->next;
@@ -446,7 +591,8 @@ template <typename... Args>
 void List<T, Allocator>::emplace(const_iterator iter, Args&&... args) {
   Node* new_node = node_allocator_traits::allocate(node_allocator_, 1);
   try {
-    node_allocator_traits::construct(node_allocator_, new_node, args...);
+    node_allocator_traits::construct(node_allocator_, new_node,
+                                     std::forward<Args>(args)...);
   } catch (...) {
     node_allocator_traits::deallocate(node_allocator_, new_node, 1);
     throw;
@@ -456,4 +602,244 @@ void List<T, Allocator>::emplace(const_iterator iter, Args&&... args) {
   new_node->next = iter.node_;
   iter.node_->previous = new_node;
   ++size_;
-}
\ No newline at end of file
+}
+
+template <typename T, typename Allocator>
+void List<T, Allocator>::transfer(BaseNode* position, BaseNode* first,
+                                  BaseNode* last) {
+  if (first == last || position == last) {
+    return;
+  }
+  BaseNode* tail = last->previous;
+  first->previous->next = last;
+  last->previous = first->previous;
+  first->previous = position->previous;
+  position->previous->next = first;
+  tail->next = position;
+  position->previous = tail;
+}
+
+template <typename T, typename Allocator>
+void List<T, Allocator>::splice(const_iterator position, List& other) {
+  if (&other == this || other.size_ == 0) {
+    return;
+  }
+  transfer(position.node_, other.end_.next, &other.end_);
+  size_ += other.size_;
+  other.size_ = 0;
+}
+
+template <typename T, typename Allocator>
+void List<T, Allocator>::splice(const_iterator position, List& other,
+                                const_iterator iter) {
+  BaseNode* next = iter.node_->next;
+  if (position.node_ == iter.node_ || position.node_ == next) {
+    return;
+  }
+  transfer(position.node_, iter.node_, next);
+  ++size_;
+  --other.size_;
+}
+
+template <typename T, typename Allocator>
+void List<T, Allocator>::splice(const_iterator position, List& other,
+                                const_iterator first, const_iterator last) {
+  if (&other != this) {
+    size_t count = 0;
+    for (const_iterator iter = first; iter != last; ++iter) {
+      ++count;
+    }
+    size_ += count;
+    other.size_ -= count;
+  }
+  transfer(position.node_, first.node_, last.node_);
+}
+
+template <typename T, typename Allocator>
+template <typename Compare>
+typename List<T, Allocator>::BaseNode* List<T, Allocator>::merge_runs(
+    BaseNode* first, BaseNode* second, Compare& compare) {
+  BaseNode head;
+  BaseNode* tail = &head;
+  while (first != nullptr && second != nullptr) {
+    if (compare(value_of(second), value_of(first))) {
+      tail->next = second;
+      second = second->next;
+    } else {
+      tail->next = first;
+      first = first->next;
+    }
+    tail = tail->next;
+  }
+  tail->next = first != nullptr ? first : second;
+  return head.next;
+}
+
+template <typename T, typename Allocator>
+void List<T, Allocator>::merge(List& other) {
+  merge(other, std::less<T>());
+}
+
+template <typename T, typename Allocator>
+template <typename Compare>
+void List<T, Allocator>::merge(List& other, Compare compare) {
+  if (&other == this) {
+    return;
+  }
+  BaseNode* current = end_.next;
+  BaseNode* incoming = other.end_.next;
+  while (current != &end_ && incoming != &other.end_) {
+    if (compare(value_of(incoming), value_of(current))) {
+      BaseNode* run_end = incoming->next;
+      while (run_end != &other.end_ &&
+             compare(value_of(run_end), value_of(current))) {
+        run_end = run_end->next;
+      }
+      transfer(current, incoming, run_end);
+      incoming = run_end;
+    } else {
+      current = current->next;
+    }
+  }
+  if (incoming != &other.end_) {
+    transfer(&end_, incoming, &other.end_);
+  }
+  size_ += other.size_;
+  other.size_ = 0;
+}
+
+template <typename T, typename Allocator>
+void List<T, Allocator>::sort() {
+  sort(std::less<T>());
+}
+
+template <typename T, typename Allocator>
+template <typename Compare>
+void List<T, Allocator>::sort(Compare compare) {
+  if (size_ < 2) {
+    return;
+  }
+  const size_t max_bins = 64;
+  BaseNode* bins[max_bins] = {};
+  size_t used_bins = 0;
+  end_.previous->next = nullptr;
+  BaseNode* rest = end_.next;
+  while (rest != nullptr) {
+    BaseNode* carry = rest;
+    rest = rest->next;
+    carry->next = nullptr;
+    size_t i = 0;
+    for (; i < used_bins && bins[i] != nullptr; ++i) {
+      carry = merge_runs(bins[i], carry, compare);
+      bins[i] = nullptr;
+    }
+    bins[i] = carry;
+    used_bins = std::max(used_bins, i + 1);
+  }
+  BaseNode* sorted = nullptr;
+  for (size_t i = 0; i < used_bins; ++i) {
+    if (bins[i] != nullptr) {
+      sorted = merge_runs(bins[i], sorted, compare);
+    }
+  }
+  BaseNode* previous = &end_;
+  for (BaseNode* node = sorted; node != nullptr; node = node->next) {
+    previous->next = node;
+    node->previous = previous;
+    previous = node;
+  }
+  previous->next = &end_;
+  end_.previous = previous;
+}
+
+template <typename T, typename Allocator>
+void List<T, Allocator>::reverse() {
+  BaseNode* node = &end_;
+  do {
+    std::swap(node->next, node->previous);
+    node = node->previous;
+  } while (node != &end_);
+}
+
+template <typename T, typename Allocator>
+void List<T, Allocator>::unique() {
+  unique(std::equal_to<T>());
+}
+
+template <typename T, typename Allocator>
+template <typename BinaryPredicate>
+void List<T, Allocator>::unique(BinaryPredicate predicate) {
+  if (size_ < 2) {
+    return;
+  }
+  BaseNode* kept = end_.next;
+  while (kept->next != &end_) {
+    if (predicate(value_of(kept), value_of(kept->next))) {
+      erase(const_iterator(kept->next));
+    } else {
+      kept = kept->next;
+    }
+  }
+}
+
+template <typename T, typename Allocator>
+void List<T, Allocator>::compact() {
+  List<T, Allocator> fresh(get_allocator());
+  const_iterator source = cbegin();
+  auto take = [&](Node* node) {
+    node_allocator_traits::construct(
+        node_allocator_, node,
+        std::move_if_noexcept(static_cast<Node*>(source.node_)->value));
+    ++source;
+  };
+  if constexpr (batch_nodes) {
+    fresh.append_nodes(size_, take);
+  } else {
+    // Nodes come one allocation at a time here, so get all of them before
+    // the first value is moved: a bad_alloc then leaves *this untouched.
+    std::vector<Node*> nodes;
+    nodes.reserve(size_);
+    try {
+      for (size_t i = 0; i < size_; ++i) {
+        nodes.push_back(
+            node_allocator_traits::allocate(fresh.node_allocator_, 1));
+      }
+    } catch (...) {
+      for (Node* node : nodes) {
+        node_allocator_traits::deallocate(fresh.node_allocator_, node, 1);
+      }
+      throw;
+    }
+    for (size_t i = 0; i < size_; ++i) {
+      try {
+        take(nodes[i]);
+      } catch (...) {
+        for (size_t j = i; j < size_; ++j) {
+          node_allocator_traits::deallocate(fresh.node_allocator_, nodes[j],
+                                            1);
+        }
+        throw;
+      }
+      fresh.link_back(nodes[i]);
+    }
+  }
+  swap_nodes(fresh);
+}
+
+template <typename T, typename Allocator>
+double List<T, Allocator>::fragmentation() const {
+  if (size_ < 2) {
+    return 0.0;
+  }
+  const uintptr_t window = 4 * sizeof(Node);
+  size_t scattered = 0;
+  for (const BaseNode* node = end_.next; node->next != &end_;
+       node = node->next) {
+    uintptr_t from = reinterpret_cast<uintptr_t>(node);
+    uintptr_t to = reinterpret_cast<uintptr_t>(std::to_address(node->next));
+    if (to <= from || to - from > window) {
+      ++scattered;
+    }
+  }
+  return static_cast<double>(scattered) / static_cast<double>(size_ - 1);
+}
@@ -2,10 +2,12 @@
 #include <stdexcept>
 #include <string>
 #include <list>
+#include <random>
 #include <vector>
 #include <deque>
 #include <memory>
 #include <iostream>
+#include <iterator>
 #include <fstream>
 #include <algorithm>
 #include <type_traits>
@@ -414,6 +416,493 @@ void TestWhimsicalAllocator() {
     }
 }
 
+void TestRollbackChurn() {
+    using namespace std::chrono;
+
+    StackStorage<200'000> storage;
+    StackAllocator<int, 200'000> alloc(storage);
+    List<int, StackAllocator<int, 200'000>> lst(alloc);
+
+    for (int i = 0; i < 100; ++i) {
+        lst.push_back(i);
+    }
+    const size_t base = storage.used();
+
+    auto start = high_resolution_clock::now();
+    size_t peak = 0;
+    for (int round = 0; round < 100'000; ++round) {
+        for (int i = 0; i < 50; ++i) {
+            lst.push_back(i);
+        }
+        peak = std::max(peak, storage.used());
+        for (int i = 0; i < 50; ++i) {
+            lst.pop_back();
+        }
+        assert(storage.used() == base);
+    }
+    auto finish = high_resolution_clock::now();
+
+    // 5'000'000 node allocations in total, far more than 200'000 bytes
+    assert(lst.size() == 100);
+    assert(peak < 200'000);
+
+    lst.clear();
+    assert(storage.used() == 0);
+
+    std::cerr << " push_back/pop_back churn: " << duration_cast<milliseconds>(finish - start).count()
+              << " ms, peak storage usage " << peak << " bytes" << std::endl;
+}
+
+void TestCheckpoints() {
+    StackStorage<200'000> storage;
+    StackAllocator<int, 200'000> alloc(storage);
+
+    int* persistent = alloc.allocate(10);
+    const auto checkpoint = storage.mark();
+    const size_t used = storage.used();
+
+    {
+        ArenaScope<StackStorage<200'000>> request(storage);
+        List<int, StackAllocator<int, 200'000>> temporary(alloc);
+        for (int i = 0; i < 1'000; ++i) {
+            temporary.push_back(i);
+            temporary.push_front(i);
+        }
+        // erasing from the middle can not be rolled back by deallocate
+        auto it = temporary.begin();
+        std::advance(it, 500);
+        for (int i = 0; i < 100; ++i) {
+            temporary.erase(it++);
+        }
+        assert(storage.used() > used);
+
+        {
+            ArenaScope<StackStorage<200'000>> nested(storage);
+            alloc.allocate(1'000);
+        }
+        assert(storage.used() > used);
+    }
+    assert(storage.used() == used);
+
+    char* scratch = StackAllocator<char, 200'000>(alloc).allocate(64);
+    std::fill(scratch, scratch + 64, 'x');
+    storage.rewind(checkpoint);
+    assert(storage.used() == used);
+#ifndef NDEBUG
+    for (int i = 0; i < 64; ++i) {
+        assert(scratch[i] == static_cast<char>(StackStorage<200'000>::poison));
+    }
+#endif
+
+    // a stale checkpoint never moves the storage forward
+    alloc.allocate(100);
+    auto later = storage.mark();
+    storage.rewind(checkpoint);
+    storage.rewind(later);
+    assert(storage.used() == used);
+
+    assert(alloc.allocate(1) == persistent + 10);
+}
+
+void TestStorageStats() {
+    static_assert(sizeof(StackStorage<1'000>) == sizeof(StackStorage<1'000, NoStackStats>));
+    static_assert(sizeof(StackStorage<1'000>) <= 1'000 + 2 * sizeof(size_t));
+
+    StackStorage<1'000, StackStats> storage;
+    StackAllocator<char, 1'000, StackStats> charalloc(storage);
+    StackAllocator<int, 1'000, StackStats> intalloc(charalloc);
+
+    charalloc.allocate(3);
+    intalloc.allocate(2);
+    assert(storage.stats().allocations() == 2);
+    assert(storage.stats().bytes_requested() == 3 + 2 * sizeof(int));
+    assert(storage.stats().padding_bytes() == alignof(int) - 3 % alignof(int));
+    assert(storage.stats().allocations_of<char>() == 1);
+    assert(storage.stats().allocations_of<int>() == 1);
+
+    {
+        List<int, StackAllocator<int, 1'000, StackStats>> lst(intalloc);
+        for (int i = 0; i < 10; ++i) {
+            lst.push_back(i);
+        }
+    }
+    assert(intalloc.stats().allocations() == 12);
+    const size_t high_water = intalloc.stats().high_water_mark();
+    assert(high_water > storage.used());
+
+    try {
+        intalloc.allocate(1'000);
+        assert(false);
+    } catch (std::bad_alloc&) {}
+    assert(storage.stats().failed_allocations() == 1);
+    assert(storage.stats().high_water_mark() == high_water);
+
+    std::ostringstream report;
+    storage.stats().report(report);
+    assert(report.str().find("failed allocations: 1") != std::string::npos);
+    assert(report.str().find("high-water mark: " + std::to_string(high_water)) != std::string::npos);
+}
+
+void TestSpliceMergeSort() {
+    StackStorage<100'000> storage;
+    StackAllocator<std::pair<int, int>, 100'000> alloc(storage);
+    using PairList = List<std::pair<int, int>, StackAllocator<std::pair<int, int>, 100'000>>;
+
+    PairList lst(alloc);
+    std::vector<std::pair<int, int>> expected;
+    for (int i = 0; i < 1'000; ++i) {
+        lst.push_back({(i * 7919) % 37, i});
+        expected.push_back({(i * 7919) % 37, i});
+    }
+    const size_t used = storage.used();
+    auto by_key = [](const auto& a, const auto& b) { return a.first < b.first; };
+    lst.sort(by_key);
+    std::stable_sort(expected.begin(), expected.end(), by_key);
+    assert(storage.used() == used);
+    assert(std::equal(lst.begin(), lst.end(), expected.begin(), expected.end()));
+    assert(std::equal(lst.rbegin(), lst.rend(), expected.rbegin(), expected.rend()));
+
+    lst.reverse();
+    assert(std::equal(lst.rbegin(), lst.rend(), expected.begin(), expected.end()));
+    lst.reverse();
+
+    PairList other(alloc);
+    for (int i = 0; i < 100; ++i) {
+        other.push_back({i % 40, -i});
+    }
+    other.sort(by_key);
+    expected.insert(expected.end(), other.begin(), other.end());
+    std::stable_sort(expected.begin(), expected.end(), by_key);
+    auto* first_node = &*other.begin();
+    lst.merge(other, by_key);
+    assert(other.size() == 0 && other.begin() == other.end());
+    assert(lst.size() == 1'100);
+    assert(std::equal(lst.begin(), lst.end(), expected.begin(), expected.end()));
+    assert(std::find_if(lst.begin(), lst.end(), [&](const auto& p) { return &p == first_node; }) != lst.end());
+
+    List<int> numbers;
+    List<int> tail;
+    for (int i = 0; i < 5; ++i) {
+        numbers.push_back(i);
+        tail.push_back(i + 10);
+    }
+    numbers.splice(std::next(numbers.begin()), tail, std::next(tail.begin()), std::prev(tail.end()));
+    assert(numbers.size() == 8 && tail.size() == 2);
+    assert((std::vector<int>(numbers.begin(), numbers.end()) == std::vector<int>{0, 11, 12, 13, 1, 2, 3, 4}));
+    numbers.splice(numbers.begin(), numbers, std::prev(numbers.end()));
+    numbers.splice(numbers.end(), tail);
+    assert(numbers.size() == 10 && tail.size() == 0);
+    assert((std::vector<int>(numbers.begin(), numbers.end()) == std::vector<int>{4, 0, 11, 12, 13, 1, 2, 3, 10, 14}));
+    numbers.splice(numbers.end(), numbers, numbers.begin(), std::next(numbers.begin(), 2));
+    assert((std::vector<int>(numbers.begin(), numbers.end()) == std::vector<int>{11, 12, 13, 1, 2, 3, 10, 14, 4, 0}));
+    numbers.sort();
+    assert((std::vector<int>(numbers.begin(), numbers.end()) == std::vector<int>{0, 1, 2, 3, 4, 10, 11, 12, 13, 14}));
+
+    List<int> repeated;
+    for (int x : {1, 1, 2, 3, 3, 3, 1, 4, 4}) {
+        repeated.push_back(x);
+    }
+    repeated.unique();
+    assert((std::vector<int>(repeated.begin(), repeated.end()) == std::vector<int>{1, 2, 3, 1, 4}));
+    assert(repeated.size() == 5);
+
+    List<int> big;
+    std::vector<int> values(1'000'000);
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = static_cast<int>((i * 2654435761u) % 1'000'003);
+        big.push_back(values[i]);
+    }
+    auto start = std::chrono::high_resolution_clock::now();
+    big.sort();
+    auto in_place = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::high_resolution_clock::now() - start).count();
+    start = std::chrono::high_resolution_clock::now();
+    std::vector<int> copy(values.begin(), values.end());
+    std::sort(copy.begin(), copy.end());
+    std::list<int> copied_back(copy.begin(), copy.end());
+    auto via_vector = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::high_resolution_clock::now() - start).count();
+    assert(std::equal(big.begin(), big.end(), copy.begin(), copy.end()));
+    std::cerr << " List::sort: " << in_place << " ms, copy + std::sort + copy back: " << via_vector << " ms" << std::endl;
+}
+
+void TestBatchAllocation() {
+    static_assert(allows_partial_deallocation<StackAllocator<int, 1'000>>::value);
+    static_assert(!allows_partial_deallocation<std::allocator<int>>::value);
+
+    StackStorage<1'000'000, StackStats> storage;
+    StackAllocator<int, 1'000'000, StackStats> alloc(storage);
+    using StatList = List<int, StackAllocator<int, 1'000'000, StackStats>>;
+    const size_t used = storage.used();
+
+    {
+        StatList filled(1'000, 5, alloc);
+        assert(storage.stats().allocations() == 1);
+        assert(filled.size() == 1'000);
+        assert(std::count(filled.begin(), filled.end(), 5) == 1'000);
+
+        std::vector<int> source = {3, 1, 4, 1, 5, 9, 2, 6};
+        StatList ranged(source.begin(), source.end(), alloc);
+        assert(storage.stats().allocations() == 2);
+        assert(std::equal(ranged.begin(), ranged.end(), source.begin(), source.end()));
+
+        StatList copy = ranged;
+        assert(storage.stats().allocations() == 3);
+        copy.push_back(7);
+        assert(copy.size() == 9);
+
+        std::istringstream input("10 20 30");
+        StatList streamed(std::istream_iterator<int>(input), std::istream_iterator<int>(), alloc);
+        assert(streamed.size() == 3 && *streamed.rbegin() == 30);
+    }
+    assert(storage.used() == used);
+
+    {
+        StatList filled(100, alloc);
+        filled.clear();
+        assert(storage.used() == used);
+        filled.push_back(1);
+    }
+    assert(storage.used() == used);
+
+    Accountant::reset();
+    ThrowingAccountant::need_throw = true;
+    StackAllocator<ThrowingAccountant, 1'000'000, StackStats> throwing_alloc(storage);
+    try {
+        List<ThrowingAccountant, StackAllocator<ThrowingAccountant, 1'000'000, StackStats>> lst(8, throwing_alloc);
+        assert(false);
+    } catch (...) {
+        assert(Accountant::ctor_calls == 4);
+        assert(Accountant::dtor_calls == 4);
+    }
+    ThrowingAccountant::need_throw = false;
+    assert(storage.used() == used);
+
+    using namespace std::chrono;
+    StackStorage<100'000'000> big_storage;
+    StackAllocator<int, 100'000'000> big_alloc(big_storage);
+    auto start = high_resolution_clock::now();
+    for (int round = 0; round < 10; ++round) {
+        List<int, StackAllocator<int, 100'000'000>> lst(big_alloc);
+        for (int i = 0; i < 1'000'000; ++i) {
+            lst.push_back(i);
+        }
+    }
+    auto one_by_one = high_resolution_clock::now();
+    for (int round = 0; round < 10; ++round) {
+        List<int, StackAllocator<int, 100'000'000>> lst(1'000'000, 0, big_alloc);
+    }
+    auto batched = high_resolution_clock::now();
+    assert(big_storage.used() == 0);
+    std::cerr << " 10 x 1'000'000 nodes: push_back loop " << duration_cast<milliseconds>(one_by_one - start).count()
+              << " ms, sized constructor " << duration_cast<milliseconds>(batched - one_by_one).count() << " ms" << std::endl;
+}
+
+template <typename Alloc>
+void ShuffleBySplicing(List<int, Alloc>& lst, std::mt19937& gen) {
+    std::vector<typename List<int, Alloc>::const_iterator> order;
+    for (auto it = lst.cbegin(); it != lst.cend(); ++it) {
+        order.push_back(it);
+    }
+    std::shuffle(order.begin(), order.end(), gen);
+    for (auto it : order) {
+        lst.splice(lst.cend(), lst, it);
+    }
+}
+
+template <typename Alloc>
+long long TraverseSum(const List<int, Alloc>& lst, int rounds) {
+    long long sum = 0;
+    for (int round = 0; round < rounds; ++round) {
+        for (int x : lst) {
+            sum += x;
+        }
+    }
+    return sum;
+}
+
+void TestCompaction() {
+    std::mt19937 gen(38);
+
+    List<std::string> strings;
+    for (int i = 0; i < 100; ++i) {
+        strings.push_back(std::string(50, 'a' + i % 26));
+    }
+    List<std::string> expected_strings = strings;
+    const std::string* old_address = &*strings.begin();
+    strings.compact();
+    assert(&*strings.begin() != old_address);
+    assert(std::equal(strings.begin(), strings.end(), expected_strings.begin(), expected_strings.end()));
+    List<std::string> empty;
+    empty.compact();
+    assert(empty.size() == 0 && empty.fragmentation() == 0.0);
+    strings = empty;
+    assert(strings.size() == 0 && strings.begin() == strings.end());
+
+    using namespace std::chrono;
+    StackAllocator<int, STORAGE_SIZE> alloc(STATIC_STORAGE);
+    List<int, StackAllocator<int, STORAGE_SIZE>> lst(alloc);
+    for (int i = 0; i < 1'000'000; ++i) {
+        lst.push_back(i);
+    }
+    assert(lst.fragmentation() == 0.0);
+    ShuffleBySplicing(lst, gen);
+    const double scattered = lst.fragmentation();
+    assert(scattered > 0.9);
+    std::vector<int> before(lst.begin(), lst.end());
+
+    auto start = high_resolution_clock::now();
+    long long sum = TraverseSum(lst, 10);
+    auto traversed = high_resolution_clock::now();
+    lst.compact();
+    auto compacted = high_resolution_clock::now();
+    assert(TraverseSum(lst, 10) == sum);
+    auto traversed_again = high_resolution_clock::now();
+
+    assert(lst.fragmentation() == 0.0);
+    assert(std::equal(lst.begin(), lst.end(), before.begin(), before.end()));
+    std::cerr << " fragmentation " << scattered << " -> " << lst.fragmentation()
+              << ", 10 traversals: " << duration_cast<milliseconds>(traversed - start).count()
+              << " ms before, " << duration_cast<milliseconds>(traversed_again - compacted).count()
+              << " ms after compact() which took " << duration_cast<milliseconds>(compacted - traversed).count()
+              << " ms" << std::endl;
+}
+
+// allocations FailingAllocator of any type still grants before throwing
+size_t allocation_budget = static_cast<size_t>(-1);
+
+// std::allocator that throws bad_alloc once allocation_budget runs out
+template <typename T>
+struct FailingAllocator {
+    using value_type = T;
+
+    FailingAllocator() = default;
+    template <typename U>
+    FailingAllocator(const FailingAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        if (allocation_budget == 0) {
+            throw std::bad_alloc();
+        }
+        --allocation_budget;
+        return std::allocator<T>().allocate(n);
+    }
+    void deallocate(T* ptr, size_t n) {
+        std::allocator<T>().deallocate(ptr, n);
+    }
+
+    template <typename U>
+    bool operator==(const FailingAllocator<U>&) const {
+        return true;
+    }
+    template <typename U>
+    bool operator!=(const FailingAllocator<U>&) const {
+        return false;
+    }
+};
+
+void TestCompactionFailure() {
+    List<std::string, FailingAllocator<std::string>> strings;
+    for (int i = 0; i < 100; ++i) {
+        strings.push_back(std::string(50, 'a' + i % 26));
+    }
+    std::vector<std::string> expected(strings.begin(), strings.end());
+
+    // the allocator gives out half of the nodes compact() needs, then throws
+    allocation_budget = 50;
+    try {
+        strings.compact();
+        assert(false);
+    } catch (std::bad_alloc&) {}
+    allocation_budget = static_cast<size_t>(-1);
+    assert(std::equal(strings.begin(), strings.end(), expected.begin(), expected.end()));
+
+    strings.compact();
+    assert(std::equal(strings.begin(), strings.end(), expected.begin(), expected.end()));
+}
+
+struct MoveCounter {
+    static size_t copies;
+    static size_t moves;
+    int value = 0;
+
+    MoveCounter(int value) : value(value) {}
+    MoveCounter(const MoveCounter& other) : value(other.value) {
+        ++copies;
+    }
+    MoveCounter(MoveCounter&& other) noexcept : value(other.value) {
+        ++moves;
+    }
+};
+
+size_t MoveCounter::copies = 0;
+size_t MoveCounter::moves = 0;
+
+template <typename Alloc>
+List<MoveCounter, Alloc> MakeCounters(int count, const Alloc& alloc) {
+    List<MoveCounter, Alloc> result(alloc);
+    for (int i = 0; i < count; ++i) {
+        result.emplace_back(i);
+    }
+    return result;
+}
+
+void TestMoveSemantics() {
+    using CounterAlloc = StackAllocator<MoveCounter, 100'000, StackStats>;
+    StackStorage<100'000, StackStats> storage;
+    StackStorage<100'000, StackStats> other_storage;
+    CounterAlloc alloc(storage);
+    CounterAlloc other_alloc(other_storage);
+
+    List<MoveCounter, CounterAlloc> lst(alloc);
+    lst.push_back(MoveCounter(1));
+    lst.push_front(MoveCounter(0));
+    lst.insert(lst.cend(), MoveCounter(2));
+    lst.emplace_back(3);
+    lst.emplace_front(-1);
+    assert(MoveCounter::copies == 0);
+    assert(MoveCounter::moves == 3);
+
+    List<MoveCounter, CounterAlloc> returned = MakeCounters(50, alloc);
+    const size_t allocations = storage.stats().allocations();
+    List<MoveCounter, CounterAlloc> stolen(std::move(returned));
+    assert(stolen.size() == 50 && returned.size() == 0);
+    assert(returned.begin() == returned.end());
+    returned.push_back(MoveCounter(7));
+    assert(returned.size() == 1);
+
+    const MoveCounter* first = &*stolen.begin();
+    lst = std::move(stolen);
+    assert(&*lst.begin() == first);
+    assert(lst.size() == 50 && stolen.size() == 0);
+    assert(storage.stats().allocations() == allocations + 1);
+    assert(MoveCounter::copies == 0);
+
+    List<MoveCounter, CounterAlloc> foreign(other_alloc);
+    foreign.emplace_back(100);
+    size_t moves = MoveCounter::moves;
+    foreign = std::move(lst);
+    assert(foreign.size() == 50 && lst.size() == 0);
+    assert(MoveCounter::moves == moves + 50);
+    assert(MoveCounter::copies == 0);
+    assert(foreign.get_allocator() == other_alloc);
+    assert(foreign.begin()->value == 0 && foreign.rbegin()->value == 49);
+
+    static_assert(std::is_nothrow_move_constructible_v<List<int>>);
+    static_assert(std::is_nothrow_move_assignable_v<List<int>>);
+    static_assert(!std::is_nothrow_move_assignable_v<List<int, StackAllocator<int, 10>>>);
+
+    List<std::unique_ptr<int>> owners;
+    owners.push_back(std::make_unique<int>(1));
+    owners.emplace_back(new int(2));
+    owners.emplace(owners.cbegin(), std::make_unique<int>(0));
+    List<std::unique_ptr<int>> moved_owners(std::move(owners));
+    int expected = 0;
+    for (const auto& owner : moved_owners) {
+        assert(*owner == expected++);
+    }
+}
+
 template <class List>
 int ListPerformanceTest(List&& l) {
     using namespace std::chrono;
@@ -628,6 +1117,38 @@ int main() {
     TestWhimsicalAllocator();
     
     std::cerr << "Test 7 (Allocator Awareness) passed." << std::endl;
+
+    TestRollbackChurn();
+
+    std::cerr << "Test 8 (StackStorage rollback) passed." << std::endl;
+
+    TestCheckpoints();
+
+    std::cerr << "Test 9 (StackStorage checkpoints) passed." << std::endl;
+
+    TestStorageStats();
+
+    std::cerr << "Test 10 (StackStorage statistics) passed." << std::endl;
+
+    TestSpliceMergeSort();
+
+    std::cerr << "Test 11 (splice, merge and sort) passed." << std::endl;
+
+    TestBatchAllocation();
+
+    std::cerr << "Test 12 (batch node allocation) passed." << std::endl;
+
+    TestCompaction();
+
+    std::cerr << "Test 13 (compaction) passed." << std::endl;
+
+    TestMoveSemantics();
+
+    std::cerr << "Test 14 (move semantics) passed." << std::endl;
+
+    TestCompactionFailure();
+
+    std::cerr << "Test 15 (compaction when the allocator throws) passed." << std::endl;
     
     std::cerr << "Starting performance test. First, let's test performance of different allocators with std::list." << std::endl;
 
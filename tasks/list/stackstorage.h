@@ -0,0 +1,259 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <new>
+#include <ostream>
+#include <typeindex>
+#include <type_traits>
+#include <typeinfo>
+
+struct NoStackStats {
+  void on_allocation(const std::type_info&, size_t, size_t, size_t) {
+  }
+  void on_failure(const std::type_info&, size_t) {
+  }
+};
+
+class StackStats {
+ private:
+  size_t allocations_ = 0;
+  size_t failed_allocations_ = 0;
+  size_t bytes_requested_ = 0;
+  size_t padding_bytes_ = 0;
+  size_t high_water_mark_ = 0;
+  std::map<std::type_index, size_t> allocations_by_type_;
+
+ public:
+  void on_allocation(const std::type_info& type, size_t bytes, size_t padding,
+                     size_t used) {
+    ++allocations_;
+    ++allocations_by_type_[type];
+    bytes_requested_ += bytes;
+    padding_bytes_ += padding;
+    high_water_mark_ = std::max(high_water_mark_, used);
+  }
+
+  void on_failure(const std::type_info&, size_t) {
+    ++failed_allocations_;
+  }
+
+  size_t allocations() const {
+    return allocations_;
+  }
+
+  size_t failed_allocations() const {
+    return failed_allocations_;
+  }
+
+  size_t bytes_requested() const {
+    return bytes_requested_;
+  }
+
+  size_t padding_bytes() const {
+    return padding_bytes_;
+  }
+
+  size_t high_water_mark() const {
+    return high_water_mark_;
+  }
+
+  template <typename T>
+  size_t allocations_of() const {
+    auto iter = allocations_by_type_.find(std::type_index(typeid(T)));
+    return iter == allocations_by_type_.end() ? 0 : iter->second;
+  }
+
+  void report(std::ostream& out) const;
+};
+
+inline void StackStats::report(std::ostream& out) const {
+  out << "allocations: " << allocations_ << '\n'
+      << "failed allocations: " << failed_allocations_ << '\n'
+      << "bytes requested: " << bytes_requested_ << '\n'
+      << "bytes lost to alignment: " << padding_bytes_ << '\n'
+      << "high-water mark: " << high_water_mark_ << '\n';
+  for (const auto& [type, count] : allocations_by_type_) {
+    out << "  " << type.name() << ": " << count << '\n';
+  }
+}
+
+template <typename Allocator, typename = void>
+struct allows_partial_deallocation : std::false_type {};
+
+template <typename Allocator>
+struct allows_partial_deallocation<
+    Allocator, std::void_t<typename Allocator::partial_deallocation>>
+    : Allocator::partial_deallocation {};
+
+template <size_t N, typename Stats = NoStackStats>
+class StackStorage {
+ private:
+  char data_[N];
+  size_t shift_ = 0;
+  [[no_unique_address]] Stats stats_;
+
+ public:
+  class Checkpoint {
+   private:
+    size_t shift_;
+
+    explicit Checkpoint(size_t shift)
+        : shift_(shift) {
+    }
+
+    friend class StackStorage<N, Stats>;
+  };
+
+  static const unsigned char poison = 0xCD;
+
+  using partial_deallocation = std::true_type;
+
+  StackStorage() = default;
+  StackStorage(const StackStorage&) = delete;
+  StackStorage& operator=(const StackStorage&) = delete;
+  template <typename T>
+  T* allocate(size_t n);
+  template <typename T>
+  void deallocate(T* ptr, size_t n);
+
+  size_t used() const {
+    return shift_;
+  }
+
+  bool owns(const void* ptr) const {
+    const char* byte = static_cast<const char*>(ptr);
+    return byte >= data_ && byte < data_ + N;
+  }
+
+  Checkpoint mark() const {
+    return Checkpoint(shift_);
+  }
+
+  void rewind(Checkpoint checkpoint);
+
+  const Stats& stats() const {
+    return stats_;
+  }
+};
+
+template <size_t N, typename Stats>
+template <typename T>
+T* StackStorage<N, Stats>::allocate(size_t n) {
+  void* result = data_ + shift_;
+  size_t left = N - shift_;
+  result = std::align(alignof(T), n * sizeof(T), result, left);
+  if (result == nullptr) {
+    stats_.on_failure(typeid(T), n * sizeof(T));
+    throw std::bad_alloc();
+  }
+  size_t padding = N - shift_ - left;
+  shift_ = reinterpret_cast<char*>(result) - data_ + n * sizeof(T);
+  stats_.on_allocation(typeid(T), n * sizeof(T), padding, shift_);
+  return reinterpret_cast<T*>(result);
+}
+
+template <size_t N, typename Stats>
+template <typename T>
+void StackStorage<N, Stats>::deallocate(T* ptr, size_t n) {
+  char* begin = reinterpret_cast<char*>(ptr);
+  if (begin + n * sizeof(T) == data_ + shift_) {
+    shift_ = begin - data_;
+  }
+}
+
+template <size_t N, typename Stats>
+void StackStorage<N, Stats>::rewind(Checkpoint checkpoint) {
+  size_t shift = std::min(checkpoint.shift_, shift_);
+#ifndef NDEBUG
+  std::fill(data_ + shift, data_ + shift_, static_cast<char>(poison));
+#endif
+  shift_ = shift;
+}
+
+template <typename Arena>
+class ArenaScope {
+ private:
+  Arena& arena_;
+  typename Arena::Checkpoint checkpoint_;
+
+ public:
+  explicit ArenaScope(Arena& arena)
+      : arena_(arena),
+        checkpoint_(arena.mark()) {
+  }
+  ArenaScope(const ArenaScope&) = delete;
+  ArenaScope& operator=(const ArenaScope&) = delete;
+  ~ArenaScope() {
+    arena_.rewind(checkpoint_);
+  }
+};
+
+template <typename T, size_t N, typename Stats = NoStackStats>
+class StackAllocator {
+ public:
+  StackStorage<N, Stats>* storage_;
+  using value_type = T;
+  using partial_deallocation = std::true_type;
+
+  StackAllocator() = delete;
+  StackAllocator(StackStorage<N, Stats>& storage)
+      : storage_(&storage) {
+  }
+  ~StackAllocator() {
+  }
+
+  template <typename U>
+  StackAllocator(const StackAllocator<U, N, Stats>& other);
+
+  template <typename U>
+  StackAllocator& operator=(const StackAllocator<U, N, Stats>& other);
+
+  size_t max_size() const {
+    return N / sizeof(T);
+  }
+
+  template <typename U>
+  struct rebind {
+    using other = StackAllocator<U, N, Stats>;
+  };
+
+  T* allocate(size_t n) {
+    return storage_->template allocate<T>(n);
+  }
+
+  void deallocate(T* ptr, size_t n) {
+    storage_->deallocate(ptr, n);
+  }
+
+  const Stats& stats() const {
+    return storage_->stats();
+  }
+
+  template <typename U, size_t M>
+  bool operator==(const StackAllocator<U, M, Stats>& other) const {
+    return storage_ == other.storage_;
+  }
+
+  template <typename U, size_t M>
+  bool operator!=(const StackAllocator<U, M, Stats>& other) const {
+    return !(*this == other);
+  }
+};
+
+template <typename T, size_t N, typename Stats>
+template <typename U>
+StackAllocator<T, N, Stats>::StackAllocator(
+    const StackAllocator<U, N, Stats>& other) {
+  storage_ = other.storage_;
+}
+
+template <typename T, size_t N, typename Stats>
+template <typename U>
+StackAllocator<T, N, Stats>& StackAllocator<T, N, Stats>::operator=(
+    const StackAllocator<U, N, Stats>& other) {
+  storage_ = other.storage_;
+  return *this;
+}
@@ -0,0 +1,462 @@
+#pragma once
+
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+template <typename T, size_t K = 16, typename Allocator = std::allocator<T>>
+class UnrolledList {
+  static_assert(K >= 2, "node capacity must be at least 2");
+
+ private:
+  struct BaseNode {
+    BaseNode* next;
+    BaseNode* previous;
+    size_t count = 0;
+    BaseNode()
+        : next(this),
+          previous(this) {
+    }
+  };
+  struct Node : public BaseNode {
+    alignas(T) unsigned char buffer[K * sizeof(T)];
+
+    T* slot(size_t index) {
+      return std::launder(reinterpret_cast<T*>(buffer) + index);
+    }
+  };
+  using NodeAllocator =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+  using node_allocator_traits = typename std::allocator_traits<NodeAllocator>;
+  [[no_unique_address]] NodeAllocator node_allocator_;
+  BaseNode end_;
+  size_t size_ = 0;
+  size_t node_count_ = 0;
+
+  static Node* as_node(BaseNode* node) {
+    return static_cast<Node*>(node);
+  }
+
+  Node* make_node_after(BaseNode* previous);
+  void free_node(BaseNode* node);
+  void relocate(Node* from, size_t from_index, Node* to, size_t to_index,
+                size_t count);
+  void swap_contents(UnrolledList& other);
+
+  template <bool is_constant>
+  class base_iterator {
+   public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = std::conditional_t<is_constant, const T, T>;
+    using pointer = std::conditional_t<is_constant, const T*, T*>;
+    using reference = std::conditional_t<is_constant, const T&, T&>;
+    using difference_type = int;
+
+   private:
+    BaseNode* node_;
+    size_t index_;
+
+   public:
+    base_iterator() = delete;
+    base_iterator(const BaseNode* node, size_t index)
+        : node_(const_cast<BaseNode*>(node)),
+          index_(index) {
+    }
+
+    base_iterator& operator++();
+    base_iterator operator++(int);
+
+    base_iterator& operator--();
+    base_iterator operator--(int);
+
+    bool operator==(const base_iterator& other) const {
+      return node_ == other.node_ && index_ == other.index_;
+    }
+    bool operator!=(const base_iterator& other) const {
+      return !(*this == other);
+    }
+
+    operator base_iterator<true>() const {
+      return base_iterator<true>(node_, index_);
+    }
+
+    pointer operator->() const {
+      return as_node(node_)->slot(index_);
+    }
+
+    reference operator*() const {
+      return *as_node(node_)->slot(index_);
+    }
+
+    friend class UnrolledList<T, K, Allocator>;
+  };
+
+ public:
+  using iterator = base_iterator<false>;
+  using const_iterator = base_iterator<true>;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  UnrolledList(const Allocator& alloc)
+      : node_allocator_(alloc) {
+  }
+  UnrolledList(size_t size, const T& value, const Allocator& alloc);
+  UnrolledList()
+      : node_allocator_() {
+  }
+  UnrolledList(size_t size, const T& value);
+  UnrolledList(const UnrolledList& other);
+  UnrolledList& operator=(const UnrolledList& other);
+  ~UnrolledList() {
+    clear();
+  }
+
+  void clear();
+
+  size_t size() const {
+    return size_;
+  }
+
+  bool empty() const {
+    return size_ == 0;
+  }
+
+  size_t node_count() const {
+    return node_count_;
+  }
+
+  static constexpr size_t node_capacity() {
+    return K;
+  }
+
+  Allocator get_allocator() const {
+    return Allocator(node_allocator_);
+  }
+
+  void push_back(const T& value);
+  void push_front(const T& value);
+  void pop_back();
+  void pop_front();
+
+  iterator begin() {
+    return iterator(end_.next, 0);
+  }
+  const_iterator begin() const {
+    return const_iterator(end_.next, 0);
+  }
+  const_iterator cbegin() const {
+    return begin();
+  }
+  iterator end() {
+    return iterator(&end_, 0);
+  }
+  const_iterator end() const {
+    return const_iterator(&end_, 0);
+  }
+  const_iterator cend() const {
+    return end();
+  }
+
+  reverse_iterator rbegin() {
+    return reverse_iterator(end());
+  }
+  const_reverse_iterator rbegin() const {
+    return const_reverse_iterator(end());
+  }
+  const_reverse_iterator crbegin() const {
+    return rbegin();
+  }
+  reverse_iterator rend() {
+    return reverse_iterator(begin());
+  }
+  const_reverse_iterator rend() const {
+    return const_reverse_iterator(begin());
+  }
+  const_reverse_iterator crend() const {
+    return rend();
+  }
+
+  iterator insert(const_iterator, const T&);
+  iterator erase(const_iterator);
+
+  template <typename... Args>
+  iterator emplace(const_iterator, Args&&...);
+};
+
+template <typename T, size_t K, typename Allocator>
+template <bool is_constant>
+typename UnrolledList<T, K, Allocator>::template base_iterator<is_constant>&
+UnrolledList<T, K, Allocator>::base_iterator<is_constant>::operator++() {
+  if (++index_ >= node_->count) {
+    node_ = node_->next;
+    index_ = 0;
+  }
+  return *this;
+}
+
+template <typename T, size_t K, typename Allocator>
+template <bool is_constant>
+typename UnrolledList<T, K, Allocator>::template base_iterator<is_constant>
+UnrolledList<T, K, Allocator>::base_iterator<is_constant>::operator++(int) {
+  base_iterator<is_constant> result = *this;
+  ++(*this);
+  return result;
+}
+
+template <typename T, size_t K, typename Allocator>
+template <bool is_constant>
+typename UnrolledList<T, K, Allocator>::template base_iterator<is_constant>&
+UnrolledList<T, K, Allocator>::base_iterator<is_constant>::operator--() {
+  if (index_ == 0) {
+    node_ = node_->previous;
+    index_ = node_->count;
+  }
+  --index_;
+  return *this;
+}
+
+template <typename T, size_t K, typename Allocator>
+template <bool is_constant>
+typename UnrolledList<T, K, Allocator>::template base_iterator<is_constant>
+UnrolledList<T, K, Allocator>::base_iterator<is_constant>::operator--(int) {
+  base_iterator<is_constant> result = *this;
+  --(*this);
+  return result;
+}
+
+template <typename T, size_t K, typename Allocator>
+typename UnrolledList<T, K, Allocator>::Node*
+UnrolledList<T, K, Allocator>::make_node_after(BaseNode* previous) {
+  Node* node = node_allocator_traits::allocate(node_allocator_, 1);
+  ::new (static_cast<void*>(node)) Node;
+  node->previous = previous;
+  node->next = previous->next;
+  previous->next->previous = node;
+  previous->next = node;
+  ++node_count_;
+  return node;
+}
+
+template <typename T, size_t K, typename Allocator>
+void UnrolledList<T, K, Allocator>::free_node(BaseNode* node) {
+  node->previous->next = node->next;
+  node->next->previous = node->previous;
+  as_node(node)->~Node();
+  node_allocator_traits::deallocate(node_allocator_, as_node(node), 1);
+  --node_count_;
+}
+
+template <typename T, size_t K, typename Allocator>
+void UnrolledList<T, K, Allocator>::relocate(Node* from, size_t from_index,
+                                             Node* to, size_t to_index,
+                                             size_t count) {
+  if (from == to && to_index > from_index) {
+    for (size_t i = count; i > 0; --i) {
+      T* source = from->slot(from_index + i - 1);
+      node_allocator_traits::construct(node_allocator_,
+                                       to->slot(to_index + i - 1),
+                                       std::move_if_noexcept(*source));
+      node_allocator_traits::destroy(node_allocator_, source);
+    }
+    return;
+  }
+  for (size_t i = 0; i < count; ++i) {
+    T* source = from->slot(from_index + i);
+    node_allocator_traits::construct(node_allocator_, to->slot(to_index + i),
+                                     std::move_if_noexcept(*source));
+    node_allocator_traits::destroy(node_allocator_, source);
+  }
+}
+
+template <typename T, size_t K, typename Allocator>
+void UnrolledList<T, K, Allocator>::swap_contents(UnrolledList& other) {
+  std::swap(size_, other.size_);
+  std::swap(node_count_, other.node_count_);
+  std::swap(end_.next, other.end_.next);
+  std::swap(end_.previous, other.end_.previous);
+  for (UnrolledList* list : {this, &other}) {
+    if (list->size_ == 0) {
+      list->end_.next = &list->end_;
+      list->end_.previous = &list->end_;
+    } else {
+      list->end_.next->previous = &list->end_;
+      list->end_.previous->next = &list->end_;
+    }
+  }
+}
+
+template <typename T, size_t K, typename Allocator>
+void UnrolledList<T, K, Allocator>::clear() {
+  while (end_.previous != &end_) {
+    Node* node = as_node(end_.previous);
+    for (size_t i = node->count; i > 0; --i) {
+      node_allocator_traits::destroy(node_allocator_, node->slot(i - 1));
+    }
+    free_node(node);
+  }
+  size_ = 0;
+}
+
+template <typename T, size_t K, typename Allocator>
+UnrolledList<T, K, Allocator>::UnrolledList(size_t size, const T& value,
+                                            const Allocator& alloc)
+    : node_allocator_(alloc) {
+  try {
+    for (size_t i = 0; i < size; ++i) {
+      push_back(value);
+    }
+  } catch (...) {
+    clear();
+    throw;
+  }
+}
+
+template <typename T, size_t K, typename Allocator>
+UnrolledList<T, K, Allocator>::UnrolledList(size_t size, const T& value)
+    : UnrolledList(size, value, Allocator()) {
+}
+
+template <typename T, size_t K, typename Allocator>
+UnrolledList<T, K, Allocator>::UnrolledList(const UnrolledList& other)
+    : node_allocator_(
+          node_allocator_traits::select_on_container_copy_construction(
+              other.node_allocator_)) {
+  try {
+    for (const auto& x : other) {
+      push_back(x);
+    }
+  } catch (...) {
+    clear();
+    throw;
+  }
+}
+
+template <typename T, size_t K, typename Allocator>
+UnrolledList<T, K, Allocator>& UnrolledList<T, K, Allocator>::operator=(
+    const UnrolledList& other) {
+  if (&other == this) {
+    return *this;
+  }
+  constexpr bool propagate =
+      node_allocator_traits::propagate_on_container_copy_assignment::value;
+  UnrolledList tmp(propagate ? other.get_allocator() : get_allocator());
+  for (const auto& x : other) {
+    tmp.push_back(x);
+  }
+  clear();
+  if constexpr (propagate) {
+    node_allocator_ = other.node_allocator_;
+  }
+  swap_contents(tmp);
+  return *this;
+}
+
+template <typename T, size_t K, typename Allocator>
+void UnrolledList<T, K, Allocator>::push_back(const T& value) {
+  emplace(end(), value);
+}
+
+template <typename T, size_t K, typename Allocator>
+void UnrolledList<T, K, Allocator>::push_front(const T& value) {
+  emplace(begin(), value);
+}
+
+template <typename T, size_t K, typename Allocator>
+void UnrolledList<T, K, Allocator>::pop_back() {
+  erase(--end());
+}
+
+template <typename T, size_t K, typename Allocator>
+void UnrolledList<T, K, Allocator>::pop_front() {
+  erase(begin());
+}
+
+template <typename T, size_t K, typename Allocator>
+typename UnrolledList<T, K, Allocator>::iterator
+UnrolledList<T, K, Allocator>::insert(const_iterator iter, const T& value) {
+  return emplace(iter, value);
+}
+
+template <typename T, size_t K, typename Allocator>
+template <typename... Args>
+typename UnrolledList<T, K, Allocator>::iterator
+UnrolledList<T, K, Allocator>::emplace(const_iterator iter, Args&&... args) {
+  BaseNode* target = iter.node_;
+  size_t index = iter.index_;
+  if (target == &end_) {
+    target = end_.previous;
+    index = target->count;
+  }
+  bool fresh = false;
+  if (target == &end_) {
+    target = make_node_after(&end_);
+    index = 0;
+    fresh = true;
+  } else if (target->count == K) {
+    if (index == K) {
+      target = make_node_after(target);
+      index = 0;
+      fresh = true;
+    } else {
+      Node* upper = make_node_after(target);
+      relocate(as_node(target), K / 2, upper, 0, K - K / 2);
+      upper->count = K - K / 2;
+      target->count = K / 2;
+      if (index > K / 2) {
+        index -= K / 2;
+        target = upper;
+      }
+    }
+  }
+  Node* node = as_node(target);
+  relocate(node, index, node, index + 1, node->count - index);
+  try {
+    node_allocator_traits::construct(node_allocator_, node->slot(index),
+                                     std::forward<Args>(args)...);
+  } catch (...) {
+    relocate(node, index + 1, node, index, node->count - index);
+    if (fresh) {
+      free_node(node);
+    }
+    throw;
+  }
+  ++node->count;
+  ++size_;
+  return iterator(node, index);
+}
+
+template <typename T, size_t K, typename Allocator>
+typename UnrolledList<T, K, Allocator>::iterator
+UnrolledList<T, K, Allocator>::erase(const_iterator iter) {
+  Node* node = as_node(iter.node_);
+  size_t index = iter.index_;
+  node_allocator_traits::destroy(node_allocator_, node->slot(index));
+  relocate(node, index + 1, node, index, node->count - index - 1);
+  --node->count;
+  --size_;
+  if (node->count == 0) {
+    BaseNode* next = node->next;
+    free_node(node);
+    return iterator(next, 0);
+  }
+  Node* next = as_node(node->next);
+  if (next != &end_ && node->count < K / 2) {
+    if (next->count > K / 2) {
+      relocate(next, 0, node, node->count, 1);
+      relocate(next, 1, next, 0, next->count - 1);
+      ++node->count;
+      --next->count;
+    } else {
+      relocate(next, 0, node, node->count, next->count);
+      node->count += next->count;
+      next->count = 0;
+      free_node(next);
+    }
+  }
+  if (index < node->count) {
+    return iterator(node, index);
+  }
+  return iterator(node->next, 0);
+}
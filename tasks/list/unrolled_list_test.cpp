@@ -0,0 +1,239 @@
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <iterator>
+#include <list>
+#include <memory_resource>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "stackallocator.h"
+#include "unrolled_list.h"
+
+#ifndef NO_TEST
+
+// NOLINTBEGIN
+
+constexpr size_t STORAGE_SIZE = 10'000'000;
+StackStorage<STORAGE_SIZE> STATIC_STORAGE;
+
+struct Counted {
+    static int alive;
+    std::string value;
+
+    Counted(int x) : value(std::to_string(x)) {
+        ++alive;
+    }
+    Counted(const Counted& other) : value(other.value) {
+        ++alive;
+    }
+    Counted(Counted&& other) noexcept : value(std::move(other.value)) {
+        ++alive;
+    }
+    Counted& operator=(const Counted&) = delete;
+    ~Counted() {
+        --alive;
+    }
+    bool operator==(const Counted& other) const {
+        return value == other.value;
+    }
+};
+
+int Counted::alive = 0;
+
+template <size_t K, typename Alloc = std::allocator<Counted>>
+void CompareWithStdList(Alloc alloc = Alloc()) {
+    std::mt19937 gen(K);
+    {
+        UnrolledList<Counted, K, Alloc> lst(alloc);
+        std::list<Counted> expected;
+        for (int step = 0; step < 20'000; ++step) {
+            size_t position = expected.empty() ? 0 : gen() % (expected.size() + 1);
+            auto it = std::next(lst.begin(), position);
+            auto expected_it = std::next(expected.begin(), position);
+            unsigned action = gen() % 10;
+            if (action < 5 || expected.empty()) {
+                auto inserted = lst.insert(it, Counted(step));
+                expected.insert(expected_it, Counted(step));
+                assert(inserted->value == std::to_string(step));
+            } else if (action < 8) {
+                if (position == expected.size()) {
+                    --position;
+                    --it;
+                    --expected_it;
+                }
+                auto after = lst.erase(it);
+                auto expected_after = expected.erase(expected_it);
+                assert((after == lst.end()) == (expected_after == expected.end()));
+                assert(after == lst.end() || *after == *expected_after);
+            } else if (action == 8) {
+                lst.push_front(Counted(-step));
+                expected.push_front(Counted(-step));
+            } else {
+                lst.pop_back();
+                expected.pop_back();
+            }
+            assert(lst.size() == expected.size());
+            assert(lst.node_count() <= lst.size());
+            if (step % 1'000 == 0) {
+                assert(std::equal(lst.begin(), lst.end(), expected.begin(), expected.end()));
+                assert(std::equal(lst.rbegin(), lst.rend(), expected.rbegin(), expected.rend()));
+            }
+        }
+        assert(std::equal(lst.begin(), lst.end(), expected.begin(), expected.end()));
+
+        UnrolledList<Counted, K, Alloc> copy(lst);
+        assert(std::equal(copy.cbegin(), copy.cend(), expected.begin(), expected.end()));
+        UnrolledList<Counted, K, Alloc> empty(alloc);
+        copy = empty;
+        assert(copy.size() == 0 && copy.begin() == copy.end());
+        copy = lst;
+        assert(copy.size() == lst.size());
+        assert(Counted::alive == static_cast<int>(2 * lst.size() + expected.size()));
+    }
+    assert(Counted::alive == 0);
+}
+
+template <typename Container>
+void InsertEvery(Container& lst, size_t stride, int count) {
+    auto it = lst.begin();
+    for (int i = 0; i < count; ++i) {
+        std::advance(it, stride);
+        if constexpr (std::is_void_v<decltype(lst.insert(it, i))>) {
+            lst.insert(it, i);
+        } else {
+            it = std::next(lst.insert(it, i));
+        }
+    }
+}
+
+template <typename Container>
+void EraseEverySecond(Container& lst) {
+    auto it = lst.begin();
+    while (it != lst.end()) {
+        if constexpr (std::is_void_v<decltype(lst.erase(it))>) {
+            lst.erase(it++);
+        } else {
+            it = lst.erase(it);
+        }
+        if (it != lst.end()) {
+            ++it;
+        }
+    }
+}
+
+void TestDensity() {
+    UnrolledList<int, 8> lst;
+    for (int i = 0; i < 800; ++i) {
+        lst.push_back(i);
+    }
+    assert(lst.node_count() == 100);
+    for (int i = 0; i < 800; ++i) {
+        lst.push_front(i);
+    }
+    assert(lst.node_count() <= 300);
+    EraseEverySecond(lst);
+    assert(lst.size() == 800);
+    assert(lst.node_count() <= 2 * 800 / 8 + 1);
+    assert(std::count_if(lst.begin(), lst.end(), [](int x) { return x % 2 == 1; }) == 400);
+}
+
+void TestCopyAssignment() {
+    StackStorage<1 << 20> first;
+    StackStorage<1 << 20> second;
+    using Alloc = StackAllocator<int, 1 << 20>;
+    UnrolledList<int, 8, Alloc> a{Alloc(first)};
+    UnrolledList<int, 8, Alloc> b{Alloc(second)};
+    for (int i = 0; i < 100; ++i) {
+        a.push_back(i);
+    }
+    b.push_back(-1);
+    size_t used = first.used();
+
+    // StackAllocator does not propagate: the copy lives in b's own storage
+    b = a;
+    assert(first.used() == used && second.used() > 0);
+    assert(b.get_allocator() == Alloc(second));
+    assert(std::equal(a.begin(), a.end(), b.begin(), b.end()));
+
+    std::pmr::monotonic_buffer_resource left;
+    std::pmr::monotonic_buffer_resource right;
+    using Pmr = std::pmr::polymorphic_allocator<std::pmr::string>;
+    UnrolledList<std::pmr::string, 4, Pmr> x{Pmr(&left)};
+    UnrolledList<std::pmr::string, 4, Pmr> y{Pmr(&right)};
+    for (int i = 0; i < 20; ++i) {
+        x.push_back(std::pmr::string(40, 'a' + i));
+    }
+    y = x;
+    assert(y.get_allocator().resource() == &right);
+    assert(std::equal(x.begin(), x.end(), y.begin(), y.end()));
+}
+
+template <typename Container>
+void RunBenchmark(const char* name, Container&& lst) {
+    using namespace std::chrono;
+
+    auto start = high_resolution_clock::now();
+    for (int i = 0; i < 2'000'000; ++i) {
+        lst.push_back(i);
+    }
+    auto built = high_resolution_clock::now();
+
+    long long sum = 0;
+    for (int round = 0; round < 20; ++round) {
+        for (int x : lst) {
+            sum += x;
+        }
+    }
+    auto iterated = high_resolution_clock::now();
+
+    InsertEvery(lst, 7, 200'000);
+    auto inserted = high_resolution_clock::now();
+
+    EraseEverySecond(lst);
+    auto erased = high_resolution_clock::now();
+
+    assert(sum == 20LL * 1'999'999 * 2'000'000 / 2);
+    std::cerr << " " << name << ": push_back " << duration_cast<milliseconds>(built - start).count()
+              << " ms, 20 full iterations " << duration_cast<milliseconds>(iterated - built).count()
+              << " ms, insert " << duration_cast<milliseconds>(inserted - iterated).count()
+              << " ms, erase " << duration_cast<milliseconds>(erased - inserted).count() << " ms" << std::endl;
+}
+
+int main() {
+    CompareWithStdList<2>();
+    CompareWithStdList<5>();
+    CompareWithStdList<16>();
+    std::cerr << "Test 1 (random operations against std::list) passed." << std::endl;
+
+    {
+        StackAllocator<Counted, STORAGE_SIZE> alloc(STATIC_STORAGE);
+        CompareWithStdList<16>(alloc);
+    }
+    std::cerr << "Test 2 (UnrolledList with StackAllocator) passed." << std::endl;
+
+    TestDensity();
+    std::cerr << "Test 3 (node density after split and merge) passed." << std::endl;
+
+    TestCopyAssignment();
+    std::cerr << "Test 4 (copy assignment between allocators) passed." << std::endl;
+
+    RunBenchmark("List", List<int>());
+    RunBenchmark("UnrolledList<int, 16>", UnrolledList<int, 16>());
+    RunBenchmark("UnrolledList<int, 64>", UnrolledList<int, 64>());
+
+    std::cout << 0;
+}
+
+// NOLINTEND
+
+#else
+
+int main() {
+    std::cerr << "Tests are turned off!\n";
+}
+
+#endif
@@ -14,6 +14,10 @@ struct BaseControlBlock {
 
   virtual void delete_object() = 0;
 
+  // destroys the block and gives its memory back to the allocator it came
+  // from; the allocator is copied out first so nothing is read after the free
+  virtual void destroy_block() = 0;
+
   virtual ~BaseControlBlock() = default;
 };
 
@@ -41,15 +45,14 @@ class SharedPtr {
           deleter(deleter),
           alloc(alloc) {
     }
-    ~ControlBlock();
-
     void delete_object();
+    void destroy_block();
   };
 
   template <typename Alloc>
   struct SpecificControlBlock : public BaseControlBlock {
     Alloc alloc;
-    char object[sizeof(T)];
+    alignas(T) char object[sizeof(T)];
 
     using AllocTraitsObject = typename std::allocator_traits<Alloc>;
     using AllocNormal = typename AllocTraitsObject::template rebind_alloc<
@@ -70,9 +73,8 @@ class SharedPtr {
         : alloc(alloc) {
       new (reinterpret_cast<T*>(object)) T(std::forward<Args>(args)...);
     }
-    ~SpecificControlBlock();
-
     void delete_object();
+    void destroy_block();
   };
 
   BaseControlBlock* block_ = nullptr;
@@ -166,8 +168,10 @@ SharedPtr<T>::SharedPtr(BaseControlBlock* block)
 
 template <typename T>
 template <typename U, typename Deleter, typename Alloc>
-SharedPtr<T>::ControlBlock<U, Deleter, Alloc>::~ControlBlock() {
-  AllocNormal(alloc).deallocate(this, 1);
+void SharedPtr<T>::ControlBlock<U, Deleter, Alloc>::destroy_block() {
+  AllocNormal block_alloc(alloc);
+  this->~ControlBlock();
+  AllocTraits::deallocate(block_alloc, this, 1);
 }
 
 template <typename T>
@@ -178,8 +182,10 @@ void SharedPtr<T>::ControlBlock<U, Deleter, Alloc>::delete_object() {
 
 template <typename T>
 template <typename Alloc>
-SharedPtr<T>::SpecificControlBlock<Alloc>::~SpecificControlBlock() {
-  AllocNormal(alloc).deallocate(this, 1);
+void SharedPtr<T>::SpecificControlBlock<Alloc>::destroy_block() {
+  AllocNormal block_alloc(alloc);
+  this->~SpecificControlBlock();
+  AllocTraits::deallocate(block_alloc, this, 1);
 }
 
 template <typename T>
@@ -197,7 +203,7 @@ void SharedPtr<T>::delete_block() {
   if (block_->count_shared == 0) {
     block_->delete_object();
     if (block_->count_weak == 0) {
-      block_->~BaseControlBlock();
+      block_->destroy_block();
     }
   }
   block_ = nullptr;
@@ -222,9 +228,8 @@ template <typename U, typename Deleter, typename Alloc>
 SharedPtr<T>::SharedPtr(U* ptr, const Deleter& deleter, const Alloc& alloc) {
   auto rebinded = typename std::allocator_traits<Alloc>::template rebind_alloc<
       typename SharedPtr<T>::template ControlBlock<U, Deleter, Alloc>>(alloc);
-  block_ = rebinded.allocate(1);
-  new (static_cast<ControlBlock<U, Deleter, Alloc>*>(block_))
-      ControlBlock<U, Deleter, Alloc>(ptr, deleter, alloc);
+  auto* block = rebinded.allocate(1);
+  block_ = new (block) ControlBlock<U, Deleter, Alloc>(ptr, deleter, alloc);
   ++block_->count_shared;
 }
 
@@ -312,15 +317,15 @@ SharedPtr<T> allocateShared(const Alloc& alloc, Args&&... args) {  // NOLINT
   using traits = typename std::allocator_traits<
       typename std::allocator_traits<Alloc>::template rebind_alloc<
           typename SharedPtr<T>::template SpecificControlBlock<Alloc>>>;
-  result.block_ = rebinded.allocate(1);
-  traits::construct(
-      rebinded,
-      static_cast<typename SharedPtr<T>::template SpecificControlBlock<Alloc>*>(
-          result.block_),
-      std::forward<Args>(args)...);
-  if (result.block_ != nullptr) {
-    ++result.block_->count_shared;
+  auto* block = rebinded.allocate(1);
+  try {
+    traits::construct(rebinded, block, alloc, std::forward<Args>(args)...);
+  } catch (...) {
+    traits::deallocate(rebinded, block, 1);
+    throw;
   }
+  result.block_ = block;
+  ++result.block_->count_shared;
   return result;
 }
 
@@ -384,7 +389,7 @@ void WeakPtr<T>::delete_block() {
   }
   --block_->count_weak;
   if (block_->count_shared == 0 && block_->count_weak == 0) {
-    block_->~BaseControlBlock();
+    block_->destroy_block();
   }
   block_ = nullptr;
 }
@@ -171,6 +171,11 @@ template <class T, class Allocator>
 List<T, Allocator>::BaseNode::BaseNode(BaseNode&& other)
     : next(other.next),
       previous(other.previous) {
+  if (next == &other) {
+    next = this;
+    previous = this;
+    return;
+  }
   next->previous = this;
   previous->next = this;
   other.next = &other;
@@ -188,6 +193,11 @@ typename List<T, Allocator>::BaseNode& List<T, Allocator>::BaseNode::operator=(
 template <class T, class Allocator>
 typename List<T, Allocator>::BaseNode& List<T, Allocator>::BaseNode::operator=(
     BaseNode&& other) {
+  if (other.next == &other) {
+    next = this;
+    previous = this;
+    return *this;
+  }
   next = other.next;
   previous = other.previous;
   next->previous = this;
@@ -297,26 +307,34 @@ template <class T, class Allocator>
 List<T, Allocator>& List<T, Allocator>::operator=(
     const List<T, Allocator>& other) {
   List<T, Allocator> tmp(other);
-  if (node_allocator_traits::propagate_on_container_copy_assignment::value) {
+  if constexpr (node_allocator_traits::propagate_on_container_copy_assignment::
+                    value) {
     tmp.node_allocator_ = other.node_allocator_;
   }
-  std::swap(*this, std::move(tmp));
+  *this = std::move(tmp);
   return *this;
 }
 
 template <class T, class Allocator>
 List<T, Allocator>& List<T, Allocator>::operator=(List<T, Allocator>&& other) {
+  if (&other == this) {
+    return *this;
+  }
   if (node_allocator_ == other.node_allocator_) {
+    clear();
     end_ = std::move(other.end_);
     size_ = other.size_;
     other.size_ = 0;
   } else {
-    if (node_allocator_traits::propagate_on_container_move_assignment::value) {
+    if constexpr (node_allocator_traits::
+                      propagate_on_container_move_assignment::value) {
+      clear();
       node_allocator_ = std::move(other.node_allocator_);
       end_ = std::move(other.end_);
       size_ = other.size_;
       other.size_ = 0;
     } else {
+      const size_t old_size = size_;
       size_t i = 0;
       try {
         for (auto iter = other.begin(); i < other.size_; ++i, ++iter) {
@@ -328,7 +346,7 @@ List<T, Allocator>& List<T, Allocator>::operator=(List<T, Allocator>&& other) {
         }
         throw;
       }
-      for (size_t j = 0; j < size_ - i; ++j) {
+      for (size_t j = 0; j < old_size; ++j) {
         pop_front();
       }
     }
@@ -635,6 +653,8 @@ class UnorderedMap {
   };
 
   void rehash(size_t);
+  void relink_buckets();
+  void take_storage(UnorderedMap& other);
 
   size_t get_hash(size_t hash) const {
     return hash % buckets_count_;
@@ -648,7 +668,7 @@ class UnorderedMap {
   UnorderedMap(const Alloc& allocator);
   UnorderedMap(Alloc&& allocator);
   UnorderedMap(const UnorderedMap<Key, Value, Hash, Equal, Alloc>& other);
-  UnorderedMap(UnorderedMap<Key, Value, Hash, Equal, Alloc>&&) = default;
+  UnorderedMap(UnorderedMap<Key, Value, Hash, Equal, Alloc>&& other);
   ~UnorderedMap() = default;
 
   UnorderedMap& operator=(const UnorderedMap&);
@@ -723,8 +743,8 @@ typename UnorderedMap<Key, Value, Hash, Equal,
 
 template <class Key, class Value, class Hash, class Equal, class Alloc>
 void UnorderedMap<Key, Value, Hash, Equal, Alloc>::clear() {
-  bucket_iterators_.clear();
   storage_.clear();
+  bucket_iterators_.assign(buckets_count_, storage_.end());
 }
 
 template <class Key, class Value, class Hash, class Equal, class Alloc>
@@ -768,16 +788,44 @@ UnorderedMap<Key, Value, Hash, Equal, Alloc>::UnorderedMap(
   }
 }
 
+template <class Key, class Value, class Hash, class Equal, class Alloc>
+UnorderedMap<Key, Value, Hash, Equal, Alloc>::UnorderedMap(
+    UnorderedMap<Key, Value, Hash, Equal, Alloc>&& other)
+    : buckets_count_(other.buckets_count_),
+      hasher_(std::move(other.hasher_)),
+      equaler_(std::move(other.equaler_)),
+      hnode_allocator_(other.hnode_allocator_),
+      storage_(std::move(other.storage_)),
+      bucket_iterators_(std::move(other.bucket_iterators_)),
+      max_load_factor_(other.max_load_factor_) {
+  // empty buckets point at the sentinel, which stays inside its own List
+  for (auto& el : bucket_iterators_) {
+    if (el == other.storage_.end()) {
+      el = storage_.end();
+    }
+  }
+  other.clear();
+}
+
 template <class Key, class Value, class Hash, class Equal, class Alloc>
 UnorderedMap<Key, Value, Hash, Equal, Alloc>&
 UnorderedMap<Key, Value, Hash, Equal, Alloc>::operator=(
     const UnorderedMap<Key, Value, Hash, Equal, Alloc>& other) {
-  UnorderedMap tmp(other);
-  if (hashed_node_allocator_traits::propagate_on_container_copy_assignment::
-          value) {
-    tmp.hnode_allocator_ = other.hnode_allocator_;
+  if (&other == this) {
+    return *this;
+  }
+  constexpr bool propagate = hashed_node_allocator_traits::
+      propagate_on_container_copy_assignment::value;
+  UnorderedMap tmp(propagate ? other.hnode_allocator_ : hnode_allocator_);
+  tmp.max_load_factor_ = other.max_load_factor_;
+  for (auto& el : other) {
+    tmp.insert(el);
   }
-  swap(*this, tmp);
+  clear();
+  if constexpr (propagate) {
+    hnode_allocator_ = other.hnode_allocator_;
+  }
+  take_storage(tmp);
   return *this;
 }
 
@@ -785,23 +833,46 @@ template <class Key, class Value, class Hash, class Equal, class Alloc>
 UnorderedMap<Key, Value, Hash, Equal, Alloc>&
 UnorderedMap<Key, Value, Hash, Equal, Alloc>::operator=(
     UnorderedMap<Key, Value, Hash, Equal, Alloc>&& other) {
-  if (hnode_allocator_ != other.hnode_allocator_ &&
-      hashed_node_allocator_traits::propagate_on_container_move_assignment::
-          value) {
-    hnode_allocator_ = std::move(other.hnode_allocator_);
+  if (&other == this) {
+    return *this;
   }
-  bucket_iterators_ = std::move(other.bucket_iterators_);
-  for (auto& el : bucket_iterators_) {
-    if (el == other.storage_.end()) {
-      el = storage_.end();
+  clear();
+  if constexpr (hashed_node_allocator_traits::
+                    propagate_on_container_move_assignment::value) {
+    hnode_allocator_ = other.hnode_allocator_;
+  } else if (hnode_allocator_ != other.hnode_allocator_) {
+    // the nodes cannot change hands: rebuild them from this map's allocator
+    max_load_factor_ = other.max_load_factor_;
+    for (auto& el : other) {
+      emplace(std::move(el));
     }
+    other.clear();
+    return *this;
   }
+  take_storage(other);
+  return *this;
+}
+
+// Moves the nodes of other, which come from an allocator equal to ours, into
+// this empty map and leaves other empty.
+template <class Key, class Value, class Hash, class Equal, class Alloc>
+void UnorderedMap<Key, Value, Hash, Equal, Alloc>::take_storage(
+    UnorderedMap<Key, Value, Hash, Equal, Alloc>& other) {
   storage_ = std::move(other.storage_);
   buckets_count_ = other.buckets_count_;
   max_load_factor_ = other.max_load_factor_;
-  other.max_load_factor_ = 0;
-  other.buckets_count_ = 0;
-  return *this;
+  relink_buckets();
+  other.clear();
+}
+
+// Points every bucket at its first node in storage_ again.
+template <class Key, class Value, class Hash, class Equal, class Alloc>
+void UnorderedMap<Key, Value, Hash, Equal, Alloc>::relink_buckets() {
+  bucket_iterators_.assign(buckets_count_, storage_.end());
+  for (auto iter = storage_.end(); iter != storage_.begin();) {
+    --iter;
+    bucket_iterators_[get_hash(iter->hash)] = iter;
+  }
 }
 
 template <class Key, class Value, class Hash, class Equal, class Alloc>
@@ -948,7 +1019,7 @@ void UnorderedMap<Key, Value, Hash, Equal, Alloc>::rehash(size_t new_size) {
   }
   new_size = std::max(new_size, size_t(2));
   std::vector<typename StorageList::iterator, vector_allocator> new_vector(
-      new_size, storage_.end());
+      new_size, storage_.end(), bucket_iterators_.get_allocator());
   for (int i = storage_.size(); i > 0; --i) {
     auto iter = storage_.begin();
     size_t new_hash = iter->hash % new_size;
@@ -963,10 +1034,33 @@ void UnorderedMap<Key, Value, Hash, Equal, Alloc>::rehash(size_t new_size) {
 template <class Key, class Value, class Hash, class Equal, class Alloc>
 void UnorderedMap<Key, Value, Hash, Equal, Alloc>::swap(
     UnorderedMap<Key, Value, Hash, Equal, Alloc>& other) {
-  std::swap(hnode_allocator_, other.hnode_allocator_);
+  // with unequal allocators the Lists swap by moving elements, so every
+  // bucket has to be found again
+  const bool same_nodes = hnode_allocator_ == other.hnode_allocator_;
+  if constexpr (hashed_node_allocator_traits::propagate_on_container_swap::
+                    value) {
+    std::swap(hnode_allocator_, other.hnode_allocator_);
+  }
   std::swap(storage_, other.storage_);
   std::swap(buckets_count_, other.buckets_count_);
+  std::swap(max_load_factor_, other.max_load_factor_);
+  if (!same_nodes) {
+    relink_buckets();
+    other.relink_buckets();
+    return;
+  }
   std::swap(bucket_iterators_, other.bucket_iterators_);
+  // empty buckets point at the sentinel, which stays inside its own List
+  for (auto& el : bucket_iterators_) {
+    if (el == other.storage_.end()) {
+      el = storage_.end();
+    }
+  }
+  for (auto& el : other.bucket_iterators_) {
+    if (el == storage_.end()) {
+      el = other.storage_.end();
+    }
+  }
 }
 
 template <class Key, class Value, class Hash, class Equal, class Alloc>
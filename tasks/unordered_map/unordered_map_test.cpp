@@ -1,4 +1,6 @@
 #include "unordered_map.h"
+#include "../list/arena_resource.h"
+#include "../list/concurrent_storage.h"
 //#include <unordered_map>
 
 #include <vector>
@@ -7,6 +9,9 @@
 #include <cassert>
 
 #include <iostream>
+#include <chrono>
+#include <thread>
+#include <memory_resource>
 
 #ifndef NO_TEST
 
@@ -400,6 +405,139 @@ void TestCustomAlloc() {
     }    
 }
 
+constexpr size_t MAP_THREADS = 4;
+constexpr size_t MAP_KEYS_PER_THREAD = 50'000;
+constexpr size_t SHARED_MAP_STORAGE = 128'000'000;
+constexpr size_t LOCAL_MAP_STORAGE = 32'000'000;
+ConcurrentStackStorage<SHARED_MAP_STORAGE> SHARED_MAP_ARENA;
+
+template <typename Alloc>
+long long BuildMapsConcurrently(Alloc alloc) {
+    using namespace std::chrono;
+    auto start = high_resolution_clock::now();
+    std::vector<std::thread> threads;
+    for (size_t id = 0; id < MAP_THREADS; ++id) {
+        threads.emplace_back([alloc, id] {
+            UnorderedMap<int, int, std::hash<int>, std::equal_to<int>, Alloc> m(alloc);
+            for (size_t i = 0; i < MAP_KEYS_PER_THREAD; ++i) {
+                m.emplace(int(i * MAP_THREADS + id), int(i));
+            }
+            assert(m.size() == MAP_KEYS_PER_THREAD);
+            assert(m.at(int(id)) == 0);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+}
+
+void TestConcurrentArenas() {
+    using Pair = std::pair<const int, int>;
+    ThreadLocalArenas<StackStorage<LOCAL_MAP_STORAGE>> registry;
+
+    long long malloc_time = BuildMapsConcurrently(std::allocator<Pair>());
+    long long shared_time = BuildMapsConcurrently(
+            ConcurrentStackAllocator<Pair, SHARED_MAP_STORAGE>(SHARED_MAP_ARENA));
+    long long local_time = BuildMapsConcurrently(
+            ThreadLocalStackAllocator<Pair, LOCAL_MAP_STORAGE>(registry));
+
+    std::cerr << " " << MAP_THREADS << " threads x " << MAP_KEYS_PER_THREAD
+              << " keys: malloc " << malloc_time << " ms, ConcurrentStackStorage "
+              << shared_time << " ms, thread-local StackStorage " << local_time << " ms"
+              << std::endl;
+}
+
+StackStorage<LOCAL_MAP_STORAGE> PMR_MAP_STORAGE;
+
+void TestPolymorphicAllocator() {
+    using Pair = std::pair<const std::string, int>;
+    using Map = UnorderedMap<std::string, int, std::hash<std::string>, std::equal_to<std::string>,
+                             std::pmr::polymorphic_allocator<Pair>>;
+    StackStorage<LOCAL_MAP_STORAGE>& storage = PMR_MAP_STORAGE;
+    ArenaResource<StackStorage<LOCAL_MAP_STORAGE>> resource(storage);
+
+    Map m{std::pmr::polymorphic_allocator<Pair>(&resource)};
+    for (int i = 0; i < 10'000; ++i) {
+        m.emplace(std::to_string(i), i);
+    }
+    assert(m.size() == 10'000);
+    assert(storage.used() > 0);
+    assert(m.at("1234") == 1234);
+    m.erase(m.find("1234"));
+    assert(m.find("1234") == m.end());
+
+    size_t used = storage.used();
+    Map copy = m;
+    assert(copy.size() == m.size() && copy.at("42") == 42);
+    assert(storage.used() > used);
+
+    Map other{std::pmr::polymorphic_allocator<Pair>(&resource)};
+    other = m;
+    other["extra"] = 1;
+    assert(other.size() == m.size() + 1);
+}
+
+// m maps exactly the keys "0" ... count - 1 to i + shift
+template <typename Map>
+bool Holds(Map& m, int count, int shift) {
+    if (m.size() != static_cast<size_t>(count)) {
+        return false;
+    }
+    for (int i = 0; i < count; ++i) {
+        auto it = m.find(std::to_string(i));
+        if (it == m.end() || it->second != i + shift) {
+            return false;
+        }
+    }
+    return m.find("missing") == m.end();
+}
+
+void TestDistinctResources() {
+    using Pair = std::pair<const std::string, int>;
+    using Alloc = std::pmr::polymorphic_allocator<Pair>;
+    using Map = UnorderedMap<std::string, int, std::hash<std::string>, std::equal_to<std::string>,
+                             Alloc>;
+    std::pmr::unsynchronized_pool_resource first;
+    std::pmr::unsynchronized_pool_resource second;
+
+    Map a{Alloc(&first)};
+    Map b{Alloc(&second)};
+    for (int i = 0; i < 1'000; ++i) {
+        a.emplace(std::to_string(i), i);
+        b.emplace(std::to_string(i), -i);
+    }
+
+    b = a;
+    assert(Holds(b, 1'000, 0) && Holds(a, 1'000, 0));
+    b.emplace("1000", 1'000);
+    assert(Holds(b, 1'001, 0));
+
+    Map c{Alloc(&second)};
+    c.emplace("0", 5);
+    c = std::move(a);
+    assert(Holds(c, 1'000, 0));
+    assert(a.size() == 0 && a.find("1") == a.end());
+    a.emplace("7", 7);
+    assert(a.at("7") == 7);
+
+    Map d{Alloc(&first)};
+    for (int i = 0; i < 10; ++i) {
+        d.emplace(std::to_string(i), i + 1);
+    }
+    d.swap(c);
+    assert(Holds(d, 1'000, 0) && Holds(c, 10, 1));
+    c.emplace("10", 11);
+    d.erase(d.find("999"));
+    assert(Holds(c, 11, 1) && Holds(d, 999, 0));
+
+    Map e = std::move(d);
+    assert(Holds(e, 999, 0) && d.size() == 0);
+    d.emplace("1", 1);
+    e.emplace("999", 999);
+    assert(d.at("1") == 1 && Holds(e, 1'000, 0));
+}
+
 int main() {
     std::cerr << "Starting tests" << std::endl;
     SimpleTest();
@@ -414,6 +552,12 @@ int main() {
     std::cerr << "TestCustomHashAndCompare (5 of 6) passed" << std::endl;
     TestCustomAlloc();
     std::cerr << "TestCustomAlloc (6 of 6) passed" << std::endl;
+    TestConcurrentArenas();
+    std::cerr << "TestConcurrentArenas passed" << std::endl;
+    TestPolymorphicAllocator();
+    std::cerr << "TestPolymorphicAllocator passed" << std::endl;
+    TestDistinctResources();
+    std::cerr << "TestDistinctResources passed" << std::endl;
     std::cout << 0;
 }
 